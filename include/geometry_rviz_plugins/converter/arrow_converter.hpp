@@ -21,6 +21,8 @@
 #ifndef  GEOMETRY_RVIZ_PLUGINS__CONVERTER__ARROW_CONVERTER_HPP_
 #define GEOMETRY_RVIZ_PLUGINS__CONVERTER__ARROW_CONVERTER_HPP_
 
+#include <OgreSphere.h>
+
 #include <rviz_rendering/objects/arrow.hpp>
 
 #include <geometry_msgs/msg/vector3_stamped.hpp>
@@ -36,5 +38,13 @@ void rvizArrowConverter(
   const Ogre::Quaternion &,
   const ConvertArrowProperties &
 );
+
+//! Sphere enclosing the arrow that rvizArrowConverter() would build
+Ogre::Sphere rvizArrowBoundingSphere(
+  const geometry_msgs::msg::Vector3 &,
+  const Ogre::Vector3 &,
+  const Ogre::Quaternion &,
+  const ConvertArrowProperties &
+);
 }  // namespace geometry_rviz_plugins::converter
 #endif  // GEOMETRY_RVIZ_PLUGINS__CONVERTER__ARROW_CONVERTER_HPP_
@@ -23,5 +23,8 @@
 
 #include "arrow_converter.hpp"
 #include "convert_arrow_properties.hpp"
+#include "covariance_converter.hpp"
+#include "convert_covariance_properties.hpp"
+#include "magnitude_label_converter.hpp"
 
 #endif  // GEOMETRY_RVIZ_PLUGINS__CONVERTER__CONVERTER_HPP_
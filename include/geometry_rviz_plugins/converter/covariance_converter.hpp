@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__CONVERTER__COVARIANCE_CONVERTER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__CONVERTER__COVARIANCE_CONVERTER_HPP_
+
+#include <array>
+
+#include <rviz_rendering/objects/shape.hpp>
+
+#include <geometry_msgs/msg/vector3.hpp>
+
+#include <geometry_rviz_plugins/math/symmetric_eigen3.hpp>
+
+#include "convert_covariance_properties.hpp"
+
+
+namespace geometry_rviz_plugins::converter
+{
+//! Extract a 3x3 diagonal block of a row major 6x6 covariance
+math::Matrix3d covarianceBlock(const std::array<double, 36> &, int offset);
+
+void rvizCovarianceConverter(
+  rviz_rendering::Shape &,
+  const geometry_msgs::msg::Vector3 &,
+  const math::Matrix3d &,
+  const Ogre::Vector3 &,
+  const Ogre::Quaternion &,
+  const ConvertCovarianceProperties &
+);
+}  // namespace geometry_rviz_plugins::converter
+#endif  // GEOMETRY_RVIZ_PLUGINS__CONVERTER__COVARIANCE_CONVERTER_HPP_
@@ -0,0 +1,208 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__DISPLAYS__INSTRUMENTED_MESSAGE_FILTER_DISPLAY_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__DISPLAYS__INSTRUMENTED_MESSAGE_FILTER_DISPLAY_HPP_
+
+#include <memory>
+
+#include <rviz_common/message_filter_display.hpp>
+
+#include <rclcpp/exceptions.hpp>
+#include <rclcpp/serialized_message.hpp>
+
+#include <geometry_rviz_plugins/statistics/display_statistics.hpp>
+#include <geometry_rviz_plugins/statistics/statistics_reporter.hpp>
+
+
+namespace geometry_rviz_plugins::displays
+{
+/**
+ * Message filter display with statistics and an unfiltered subscription.
+ *
+ * Derived displays count their messages in display_statistics_, create the
+ * statistics properties after their own ones and report once per update.
+ * While isUnfilteredSubscription() holds, the topic is subscribed without
+ * the message filter, serialized for processSerializedMessage() or typed for
+ * processMessage(), and frames that cannot be transformed yet are rejected
+ * by the display instead of being queued.
+ */
+template<typename MessageType>
+class InstrumentedMessageFilterDisplay
+  : public rviz_common::MessageFilterDisplay<MessageType>
+{
+public:
+  using MFDClass = rviz_common::MessageFilterDisplay<MessageType>;
+  using IMFDClass = InstrumentedMessageFilterDisplay<MessageType>;
+
+  InstrumentedMessageFilterDisplay()
+  : has_decode_error_(false)
+  {
+  }
+
+protected:
+  statistics::DisplayStatistics display_statistics_;
+
+  virtual bool isSerializedSubscription() const = 0;
+  virtual bool isUnfilteredSubscription() const
+  {
+    return isSerializedSubscription();
+  }
+  virtual void processSerializedMessage(const rclcpp::SerializedMessage &) = 0;
+
+  void onEnable() override
+  {
+    display_statistics_.markEnabled(statistics::DisplayStatistics::Clock::now());
+
+    if (this->context_) {
+      statistics_reporter_->enable(this->context_->getRosNodeAbstraction());
+    }
+    MFDClass::onEnable();
+  }
+
+  void onDisable() override
+  {
+    MFDClass::onDisable();
+
+    statistics_reporter_->disable();
+  }
+
+  void subscribe() override
+  {
+    if (isUnfilteredSubscription()) {
+      subscribeUnfiltered();
+      return;
+    }
+    MFDClass::subscribe();
+
+    // The message filter keeps a single failure callback, so this one
+    // replaces the base class callback and has to report the transform too.
+    if (this->tf_filter_) {
+      this->tf_filter_->registerFailureCallback(
+        [this](
+          const typename MessageType::ConstSharedPtr & msg,
+          tf2_ros::FilterFailureReason) {
+          this->setMissingTransformToFixedFrame(msg->header.frame_id);
+          display_statistics_.countRejected();
+        }
+      );
+    }
+  }
+
+  void unsubscribe() override
+  {
+    unfiltered_subscription_.reset();
+
+    MFDClass::unsubscribe();
+  }
+
+  //! Subscribes again after the subscription mode changed
+  void resubscribe()
+  {
+    clearDecodeError();
+
+    if (!this->isEnabled()) {
+      return;
+    }
+    unsubscribe();
+    subscribe();
+  }
+
+  //! Rejects a message that failed to decode, the status is cleared by the next decoded one
+  void updateDecodeStatus(bool is_decoded)
+  {
+    if (is_decoded) {
+      clearDecodeError();
+      return;
+    }
+    display_statistics_.countRejected();
+
+    if (!has_decode_error_) {
+      has_decode_error_ = true;
+      this->setStatusStd(
+        rviz_common::properties::StatusProperty::Warn,
+        "Message",
+        "Failed to decode the serialized message."
+      );
+    }
+  }
+
+  void initializeStatisticsProperties()
+  {
+    statistics_reporter_.reset(new statistics::StatisticsReporter(this, display_statistics_));
+  }
+
+  void reportStatistics()
+  {
+    statistics_reporter_->report();
+  }
+
+private:
+  std::unique_ptr<statistics::StatisticsReporter> statistics_reporter_;
+
+  typename rclcpp::Subscription<MessageType>::SharedPtr unfiltered_subscription_;
+  bool has_decode_error_;
+
+  void subscribeUnfiltered()
+  {
+    if (!this->isEnabled() || this->topic_property_->getTopicStd().empty()) {
+      return;
+    }
+
+    try {
+      auto node = this->rviz_ros_node_.lock()->get_raw_node();
+
+      if (isSerializedSubscription()) {
+        unfiltered_subscription_ = node->template create_subscription<MessageType>(
+          this->topic_property_->getTopicStd(),
+          this->qos_profile,
+          [this](std::shared_ptr<const rclcpp::SerializedMessage> serialized_msg) {
+            processSerializedMessage(*serialized_msg);
+          }
+        );
+      } else {
+        unfiltered_subscription_ = node->template create_subscription<MessageType>(
+          this->topic_property_->getTopicStd(),
+          this->qos_profile,
+          [this](typename MessageType::ConstSharedPtr msg) {
+            this->processMessage(msg);
+          }
+        );
+      }
+      this->setStatus(rviz_common::properties::StatusProperty::Ok, "Topic", "OK");
+    } catch (const rclcpp::exceptions::InvalidTopicNameError & e) {
+      this->setStatus(
+        rviz_common::properties::StatusProperty::Error,
+        "Topic",
+        QString("Error subscribing: ") + e.what()
+      );
+    }
+  }
+
+  void clearDecodeError()
+  {
+    if (has_decode_error_) {
+      has_decode_error_ = false;
+      this->deleteStatusStd("Message");
+    }
+  }
+};
+}  // namespace geometry_rviz_plugins::displays
+#endif  // GEOMETRY_RVIZ_PLUGINS__DISPLAYS__INSTRUMENTED_MESSAGE_FILTER_DISPLAY_HPP_
@@ -21,27 +21,41 @@
 #ifndef GEOMETRY_RVIZ_PLUGINS__DISPLAYS__TWIST_STAMPED_HPP_
 #define GEOMETRY_RVIZ_PLUGINS__DISPLAYS__TWIST_STAMPED_HPP_
 
-#include <memory>
+#include <cstddef>
 
-#include <rviz_common/message_filter_display.hpp>
+#include <memory>
+#include <vector>
 
+#include <rviz_common/properties/bool_property.hpp>
 #include <rviz_common/properties/float_property.hpp>
+#include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/color_property.hpp>
+#include <rviz_common/properties/enum_property.hpp>
+#include <rviz_common/properties/ros_topic_property.hpp>
 #include <rviz_common/properties/vector_property.hpp>
 
 #include <rviz_rendering/objects/arrow.hpp>
 
+#include <std_msgs/msg/header.hpp>
 #include <geometry_msgs/msg/vector3_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 
 #include <geometry_rviz_plugins/converter/converter.hpp>
+#include <geometry_rviz_plugins/displays/instrumented_message_filter_display.hpp>
+#include <geometry_rviz_plugins/filter/temporal_filter.hpp>
+#include <geometry_rviz_plugins/history/anchor_buffer.hpp>
+#include <geometry_rviz_plugins/history/retained_history.hpp>
+#include <geometry_rviz_plugins/rendering/magnitude_label_batch.hpp>
+#include <geometry_rviz_plugins/rendering/screen_space_culler.hpp>
 
 
 namespace geometry_rviz_plugins::displays
 {
 class TwistStampedDisplay
   : public
-  rviz_common::MessageFilterDisplay<geometry_msgs::msg::TwistStamped>
+  InstrumentedMessageFilterDisplay<geometry_msgs::msg::TwistStamped>
 {
   Q_OBJECT
 
@@ -51,14 +65,29 @@ public:
   ~TwistStampedDisplay() override;
 
   void reset() override;
+  void update(float wall_dt, float ros_dt) override;
   void processMessage(geometry_msgs::msg::TwistStamped::ConstSharedPtr) override;
 
 protected:
   void onInitialize() override;
+  void onDisable() override;
+  void subscribe() override;
+  void unsubscribe() override;
+  void fixedFrameChanged() override;
+  bool isSerializedSubscription() const override;
+  bool isUnfilteredSubscription() const override;
+  void processSerializedMessage(const rclcpp::SerializedMessage &) override;
 
 private Q_SLOTS:
   void linearPropertyCallback();
   void angularPropertyCallback();
+  void lazyDeserializationPropertyCallback();
+  void anchorPropertyCallback();
+  void anchorBufferPropertyCallback();
+  void historyPropertyCallback();
+  void filterPropertyCallback();
+  void magnitudeLabelPropertyCallback();
+  void cullingPropertyCallback();
 
 private:
   const float default_linear_color_alpha_,
@@ -90,18 +119,80 @@ private:
     angular_head_scale_property_,
     angular_arrow_scale_property_;
 
-  std::unique_ptr<rviz_rendering::Arrow> rviz_linear_arrow_,
-    rviz_angular_arrow_;
+  std::unique_ptr<rviz_common::properties::IntProperty> history_length_property_;
+
+  std::unique_ptr<rviz_common::properties::EnumProperty> filter_type_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> filter_window_size_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> filter_smoothing_factor_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> lazy_deserialization_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> anchor_property_;
+  std::unique_ptr<rviz_common::properties::EnumProperty> anchor_type_property_;
+  std::unique_ptr<rviz_common::properties::RosTopicProperty> anchor_topic_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> anchor_tolerance_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> anchor_buffer_length_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> frustum_culling_property_,
+    screen_thinning_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> thinning_cell_size_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> thinning_cell_count_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> magnitude_label_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> magnitude_label_precision_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> magnitude_label_height_property_;
+  std::unique_ptr<rviz_common::properties::ColorProperty> magnitude_label_color_property_;
+
+  std::vector<std::unique_ptr<rviz_rendering::Arrow>> rviz_linear_arrows_,
+    rviz_angular_arrows_;
+
+  std::unique_ptr<rendering::MagnitudeLabelBatch> linear_magnitude_labels_,
+    angular_magnitude_labels_;
 
+  std_msgs::msg::Header serialized_header_;
+  geometry_msgs::msg::Twist serialized_twist_;
+
+  rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr anchor_pose_subscription_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr anchor_odometry_subscription_;
+  history::AnchorBuffer anchor_buffer_;
+  bool has_anchor_mismatch_;
+
+  history::RetainedHistory<geometry_msgs::msg::Twist> history_;
+  std::vector<bool> is_slot_converted_;
+  std::size_t unrendered_count_;
+  bool is_rendering_dirty_;
+
+  filter::Vector3Filter linear_filter_, angular_filter_;
+
+  rendering::ScreenSpaceCullingProperties culling_properties_;
+  rendering::ScreenSpaceCuller screen_space_culler_;
+
+  void processTwist(const std_msgs::msg::Header &, const geometry_msgs::msg::Twist &);
+
+  bool isAnchorEnabled() const;
+  void subscribeAnchor();
+  void processAnchorPose(const std_msgs::msg::Header &, const geometry_msgs::msg::Pose &);
+  void updateAnchorTopicType();
+
+  void updateHistoryRendering(std::size_t visited_count, std::size_t stale_count);
   void updateTwistRendering(
-    const geometry_msgs::msg::TwistStamped::ConstSharedPtr msg,
+    rviz_rendering::Arrow & rviz_linear_arrow,
+    rviz_rendering::Arrow & rviz_angular_arrow,
+    const geometry_msgs::msg::Twist & twist,
     const Ogre::Vector3 & ogre_position,
     const Ogre::Quaternion & ogre_quaternion
   );
 
+  void updateMagnitudeLabelProperties();
+  void updateCullingLocalProperties();
+  void updateFilterLocalProperties();
+  bool isCullingEnabled() const;
+  Ogre::Camera * getCurrentCamera() const;
+
   void updateLinearArrowLocalProperties();
   void updateAngularArrowLocalProperties();
-  void initializeRenderingObjects();
+  void resizeRenderingObjects(std::size_t);
+  void ensureSceneNode();
   void destroyRenderingObjects();
 };
 }  // namespace geometry_rviz_plugins::displays
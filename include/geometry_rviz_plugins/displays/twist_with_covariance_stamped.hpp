@@ -0,0 +1,150 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__DISPLAYS__TWIST_WITH_COVARIANCE_STAMPED_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__DISPLAYS__TWIST_WITH_COVARIANCE_STAMPED_HPP_
+
+#include <memory>
+
+#include <rviz_common/properties/bool_property.hpp>
+#include <rviz_common/properties/float_property.hpp>
+#include <rviz_common/properties/color_property.hpp>
+
+#include <rviz_rendering/objects/arrow.hpp>
+#include <rviz_rendering/objects/shape.hpp>
+
+#include <std_msgs/msg/header.hpp>
+#include <geometry_msgs/msg/twist_with_covariance_stamped.hpp>
+
+#include <geometry_rviz_plugins/converter/converter.hpp>
+#include <geometry_rviz_plugins/displays/instrumented_message_filter_display.hpp>
+#include <geometry_rviz_plugins/math/symmetric_eigen3.hpp>
+
+
+namespace geometry_rviz_plugins::displays
+{
+class TwistWithCovarianceStampedDisplay
+  : public
+  InstrumentedMessageFilterDisplay<geometry_msgs::msg::TwistWithCovarianceStamped>
+{
+  Q_OBJECT
+
+public:
+  TwistWithCovarianceStampedDisplay();
+  explicit TwistWithCovarianceStampedDisplay(rviz_common::DisplayContext *);
+  ~TwistWithCovarianceStampedDisplay() override;
+
+  void reset() override;
+  void update(float wall_dt, float ros_dt) override;
+  void processMessage(geometry_msgs::msg::TwistWithCovarianceStamped::ConstSharedPtr) override;
+
+protected:
+  void onInitialize() override;
+  bool isSerializedSubscription() const override;
+  void processSerializedMessage(const rclcpp::SerializedMessage &) override;
+
+private Q_SLOTS:
+  void linearPropertyCallback();
+  void angularPropertyCallback();
+  void lazyDeserializationPropertyCallback();
+
+private:
+  const float default_linear_color_alpha_,
+    default_linear_shaft_radius_,
+    default_linear_head_radius_,
+    default_linear_head_scale_,
+    default_linear_arrow_scale_;
+
+  const float default_angular_color_alpha_,
+    default_angular_shaft_radius_,
+    default_angular_head_radius_,
+    default_angular_head_scale_,
+    default_angular_arrow_scale_;
+
+  const float default_covariance_color_alpha_,
+    default_covariance_deviation_scale_;
+
+  converter::ConvertArrowProperties linear_arrow_properties_,
+    angular_arrow_properties_;
+
+  converter::ConvertCovarianceProperties linear_covariance_properties_,
+    angular_covariance_properties_;
+
+  std::unique_ptr<rviz_common::properties::ColorProperty> linear_color_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> linear_color_alpha_property_,
+    linear_shaft_radius_property_,
+    linear_head_radius_property_,
+    linear_head_scale_property_,
+    linear_arrow_scale_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> linear_covariance_property_;
+  std::unique_ptr<rviz_common::properties::ColorProperty> linear_covariance_color_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> linear_covariance_alpha_property_,
+    linear_covariance_scale_property_;
+
+  std::unique_ptr<rviz_common::properties::ColorProperty> angular_color_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> angular_color_alpha_property_,
+    angular_shaft_radius_property_,
+    angular_head_radius_property_,
+    angular_head_scale_property_,
+    angular_arrow_scale_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> angular_covariance_property_;
+  std::unique_ptr<rviz_common::properties::ColorProperty> angular_covariance_color_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> angular_covariance_alpha_property_,
+    angular_covariance_scale_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> lazy_deserialization_property_;
+
+  std::unique_ptr<rviz_rendering::Arrow> rviz_linear_arrow_,
+    rviz_angular_arrow_;
+
+  std::unique_ptr<rviz_rendering::Shape> rviz_linear_covariance_,
+    rviz_angular_covariance_;
+
+  std_msgs::msg::Header serialized_header_;
+  geometry_msgs::msg::Twist serialized_twist_;
+  math::Matrix3d serialized_linear_covariance_,
+    serialized_angular_covariance_;
+
+  bool has_pending_twist_;
+  geometry_msgs::msg::Twist pending_twist_;
+  math::Matrix3d pending_linear_covariance_,
+    pending_angular_covariance_;
+  Ogre::Vector3 pending_position_;
+  Ogre::Quaternion pending_quaternion_;
+
+  void processTwist(
+    const std_msgs::msg::Header &,
+    const geometry_msgs::msg::Twist &,
+    const math::Matrix3d & linear_covariance,
+    const math::Matrix3d & angular_covariance
+  );
+
+  void updateTwistRendering();
+
+  void updateLinearArrowLocalProperties();
+  void updateAngularArrowLocalProperties();
+  void initializeRenderingObjects();
+  void ensureSceneNode();
+  void destroyRenderingObjects();
+};
+}  // namespace geometry_rviz_plugins::displays
+#endif  // GEOMETRY_RVIZ_PLUGINS__DISPLAYS__TWIST_WITH_COVARIANCE_STAMPED_HPP_
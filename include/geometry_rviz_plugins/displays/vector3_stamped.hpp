@@ -21,26 +21,37 @@
 #ifndef GEOMETRY_RVIZ_PLUGINS__DISPLAYS__VECTOR3_STAMPED_HPP_
 #define GEOMETRY_RVIZ_PLUGINS__DISPLAYS__VECTOR3_STAMPED_HPP_
 
-#include <memory>
+#include <cstddef>
 
-#include <rviz_common/message_filter_display.hpp>
+#include <memory>
+#include <vector>
 
+#include <rviz_common/properties/bool_property.hpp>
 #include <rviz_common/properties/float_property.hpp>
+#include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/color_property.hpp>
+#include <rviz_common/properties/enum_property.hpp>
+#include <rviz_common/properties/string_property.hpp>
 #include <rviz_common/properties/vector_property.hpp>
 
 #include <rviz_rendering/objects/arrow.hpp>
 
+#include <std_msgs/msg/header.hpp>
 #include <geometry_msgs/msg/vector3_stamped.hpp>
 
 #include <geometry_rviz_plugins/converter/converter.hpp>
+#include <geometry_rviz_plugins/displays/instrumented_message_filter_display.hpp>
+#include <geometry_rviz_plugins/filter/temporal_filter.hpp>
+#include <geometry_rviz_plugins/history/retained_history.hpp>
+#include <geometry_rviz_plugins/rendering/magnitude_label_batch.hpp>
+#include <geometry_rviz_plugins/rendering/screen_space_culler.hpp>
 
 
 namespace geometry_rviz_plugins::displays
 {
 class Vector3StampedDisplay
   : public
-  rviz_common::MessageFilterDisplay<geometry_msgs::msg::Vector3Stamped>
+  InstrumentedMessageFilterDisplay<geometry_msgs::msg::Vector3Stamped>
 {
   Q_OBJECT
 
@@ -50,13 +61,23 @@ public:
   ~Vector3StampedDisplay() override;
 
   void reset() override;
+  void update(float wall_dt, float ros_dt) override;
   void processMessage(geometry_msgs::msg::Vector3Stamped::ConstSharedPtr) override;
 
 protected:
   void onInitialize() override;
+  void onDisable() override;
+  void fixedFrameChanged() override;
+  bool isSerializedSubscription() const override;
+  void processSerializedMessage(const rclcpp::SerializedMessage &) override;
 
 private Q_SLOTS:
   void arrowPropertyCallback();
+  void lazyDeserializationPropertyCallback();
+  void historyPropertyCallback();
+  void filterPropertyCallback();
+  void magnitudeLabelPropertyCallback();
+  void cullingPropertyCallback();
 
 private:
   const float default_color_alpha_,
@@ -73,13 +94,55 @@ private:
 
   std::unique_ptr<rviz_common::properties::VectorProperty> position_offset_property_;
 
-  std::unique_ptr<rviz_rendering::Arrow> rviz_arrow_;
+  std::unique_ptr<rviz_common::properties::IntProperty> history_length_property_;
+
+  std::unique_ptr<rviz_common::properties::EnumProperty> filter_type_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> filter_window_size_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> filter_smoothing_factor_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> lazy_deserialization_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> frustum_culling_property_,
+    screen_thinning_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> thinning_cell_size_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> thinning_cell_count_property_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> magnitude_label_property_;
+  std::unique_ptr<rviz_common::properties::IntProperty> magnitude_label_precision_property_;
+  std::unique_ptr<rviz_common::properties::StringProperty> magnitude_label_unit_property_;
+  std::unique_ptr<rviz_common::properties::FloatProperty> magnitude_label_height_property_;
+  std::unique_ptr<rviz_common::properties::ColorProperty> magnitude_label_color_property_;
+
+  std::vector<std::unique_ptr<rviz_rendering::Arrow>> rviz_arrows_;
+  std::unique_ptr<rendering::MagnitudeLabelBatch> magnitude_labels_;
 
   converter::ConvertArrowProperties convert_arrow_properties_;
 
-  void initializeRvizArrow();
-  void updateArrowLocalProperties();
+  std_msgs::msg::Header serialized_header_;
+  geometry_msgs::msg::Vector3 serialized_vector_;
+
+  history::RetainedHistory<geometry_msgs::msg::Vector3> history_;
+  std::vector<bool> is_slot_converted_;
+  std::size_t unrendered_count_;
+  bool is_rendering_dirty_;
+
+  filter::Vector3Filter vector_filter_;
 
+  rendering::ScreenSpaceCullingProperties culling_properties_;
+  rendering::ScreenSpaceCuller screen_space_culler_;
+
+  void processVector(const std_msgs::msg::Header &, const geometry_msgs::msg::Vector3 &);
+
+  void resizeRvizArrows(std::size_t);
+  void updateArrowLocalProperties();
+  void updateArrowRendering(std::size_t visited_count, std::size_t stale_count);
+  void updateMagnitudeLabelProperties();
+  void updateCullingLocalProperties();
+  void updateFilterLocalProperties();
+  bool isCullingEnabled() const;
+  Ogre::Camera * getCurrentCamera() const;
+
+  void ensureSceneNode();
   void destroyRenderingObjects();
 };
 }  // namespace geometry_rviz_plugins::displays
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__FILTER__TEMPORAL_FILTER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__FILTER__TEMPORAL_FILTER_HPP_
+
+#include <cstddef>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/vector3.hpp>
+
+
+namespace geometry_rviz_plugins::filter
+{
+enum class FilterType
+{
+  NONE,
+  LOW_PASS,
+  MOVING_AVERAGE,
+  MEDIAN
+};
+
+struct TemporalFilterProperties
+{
+  FilterType type;
+  std::size_t window_size;
+  double smoothing_factor;
+};
+
+//! Filters one sample stream over a fixed size circular window
+class ScalarFilter
+{
+public:
+  ScalarFilter();
+
+  void setProperties(const TemporalFilterProperties &);
+  void reset();
+
+  //! O(1) for low pass and moving average, O(log w) for median
+  double filter(double);
+
+private:
+  TemporalFilterProperties properties_;
+
+  std::vector<double> window_;
+  std::size_t window_head_;
+  std::size_t window_count_;
+
+  double low_pass_value_;
+
+  double window_sum_;
+  std::size_t samples_since_summation_;
+
+  // Lower half holds the median, its size is the upper size or one more.
+  std::multiset<double> lower_half_, upper_half_;
+
+  double filterLowPass(double);
+  double filterMovingAverage(double);
+  double filterMedian(double);
+
+  //! Returns true and the evicted sample if the window was full
+  bool pushWindow(double, double & evicted);
+
+  void insertMedian(double);
+  void eraseMedian(double);
+  void balanceMedian();
+};
+
+//! Filters each vector component, restarting when the source frame changes
+class Vector3Filter
+{
+public:
+  void setProperties(const TemporalFilterProperties &);
+  void reset();
+
+  geometry_msgs::msg::Vector3 filter(
+    const std::string & frame_id,
+    const geometry_msgs::msg::Vector3 &
+  );
+
+private:
+  ScalarFilter x_filter_, y_filter_, z_filter_;
+  std::string frame_id_;
+};
+}  // namespace geometry_rviz_plugins::filter
+#endif  // GEOMETRY_RVIZ_PLUGINS__FILTER__TEMPORAL_FILTER_HPP_
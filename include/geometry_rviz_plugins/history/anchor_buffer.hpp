@@ -0,0 +1,73 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__HISTORY__ANCHOR_BUFFER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__HISTORY__ANCHOR_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+
+#include <std_msgs/msg/header.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+
+
+namespace geometry_rviz_plugins::history
+{
+struct AnchorPose
+{
+  std::int64_t stamp_nanoseconds;
+  std_msgs::msg::Header header;
+  geometry_msgs::msg::Pose pose;
+};
+
+//! Bounded buffer of poses sorted by stamp for approximate time matching
+class AnchorBuffer
+{
+public:
+  explicit AnchorBuffer(std::size_t capacity = 100);
+
+  //! Returns the number of oldest poses dropped to fit the new capacity
+  std::size_t setCapacity(std::size_t);
+  std::size_t capacity() const;
+  std::size_t size() const;
+  void clear();
+
+  /**
+   * Insert a pose by stamp, appending in O(1) when stamps arrive in order.
+   * Returns the number of oldest poses dropped to keep the capacity.
+   */
+  std::size_t push(const std_msgs::msg::Header &, const geometry_msgs::msg::Pose &);
+
+  //! Nearest pose within the tolerance in O(log n), nullptr if none
+  const AnchorPose * findNearest(
+    std::int64_t stamp_nanoseconds,
+    std::int64_t tolerance_nanoseconds
+  ) const;
+
+private:
+  std::size_t capacity_;
+  std::deque<AnchorPose> poses_;
+
+  std::size_t trim();
+};
+}  // namespace geometry_rviz_plugins::history
+#endif  // GEOMETRY_RVIZ_PLUGINS__HISTORY__ANCHOR_BUFFER_HPP_
@@ -0,0 +1,240 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__HISTORY__RETAINED_HISTORY_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__HISTORY__RETAINED_HISTORY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <OgreQuaternion.h>
+#include <OgreVector.h>
+
+#include <rclcpp/time.hpp>
+
+#include <rviz_common/frame_manager_iface.hpp>
+
+#include <std_msgs/msg/header.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+
+
+namespace geometry_rviz_plugins::history
+{
+//! Raw state kept in its source frame along with its last fixed frame pose
+template<typename StateT>
+struct RetainedState
+{
+  std_msgs::msg::Header header;
+  StateT state;
+
+  Ogre::Vector3 position;
+  Ogre::Quaternion orientation;
+  bool is_transformed;
+
+  //! Pose in the header frame the state is drawn at, instead of the frame origin
+  geometry_msgs::msg::Pose anchor_pose;
+  bool is_anchored;
+};
+
+/**
+ * Ring of retained states. A state keeps its slot until it is overwritten,
+ * so objects drawn per slot only need updating for newly written slots.
+ * Indices passed to operator[] run from the oldest to the newest state.
+ */
+template<typename StateT>
+class RetainedHistory
+{
+public:
+  using Element = RetainedState<StateT>;
+
+  explicit RetainedHistory(std::size_t capacity = 1)
+  : capacity_(std::max<std::size_t>(capacity, 1)),
+    oldest_slot_(0)
+  {
+  }
+
+  /**
+   * Keep the newest states that fit the new capacity.
+   * Slots are renumbered from the oldest state, so every slot has to be redrawn.
+   * Returns the number of states dropped.
+   */
+  std::size_t setCapacity(std::size_t capacity)
+  {
+    capacity_ = std::max<std::size_t>(capacity, 1);
+
+    const std::size_t dropped_count = slots_.size() > capacity_ ? slots_.size() - capacity_ : 0;
+
+    std::vector<Element> ordered_slots;
+    ordered_slots.reserve(slots_.size() - dropped_count);
+
+    for (std::size_t index = dropped_count; index < slots_.size(); ++index) {
+      ordered_slots.push_back(std::move(slots_[slotOf(index)]));
+    }
+    slots_ = std::move(ordered_slots);
+    oldest_slot_ = 0;
+
+    return dropped_count;
+  }
+
+  std::size_t capacity() const
+  {
+    return capacity_;
+  }
+
+  std::size_t size() const
+  {
+    return slots_.size();
+  }
+
+  bool empty() const
+  {
+    return slots_.empty();
+  }
+
+  //! Drops every state and releases the slots
+  void clear()
+  {
+    std::vector<Element>().swap(slots_);
+    oldest_slot_ = 0;
+  }
+
+  //! Returns the slot written, overwriting the oldest state when full
+  std::size_t push(
+    const std_msgs::msg::Header & header,
+    const StateT & state,
+    const Ogre::Vector3 & position,
+    const Ogre::Quaternion & orientation
+  )
+  {
+    return write(
+      Element{header, state, position, orientation, true, geometry_msgs::msg::Pose(), false}
+    );
+  }
+
+  //! Retains a state drawn at a pose given in the header frame
+  std::size_t pushAnchored(
+    const std_msgs::msg::Header & header,
+    const geometry_msgs::msg::Pose & anchor_pose,
+    const StateT & state,
+    const Ogre::Vector3 & position,
+    const Ogre::Quaternion & orientation
+  )
+  {
+    return write(Element{header, state, position, orientation, true, anchor_pose, true});
+  }
+
+  /**
+   * Transform every retained state into the current fixed frame.
+   * States sharing a frame and stamp are resolved by a single lookup,
+   * anchored states then apply their anchor pose to it.
+   * Returns the number of transforms queried.
+   */
+  std::size_t retransform(rviz_common::FrameManagerIface & frame_manager)
+  {
+    using TransformKey = std::pair<std::string, std::int64_t>;
+
+    struct TransformResult
+    {
+      Ogre::Vector3 position;
+      Ogre::Quaternion orientation;
+      bool is_transformed;
+    };
+    std::map<TransformKey, TransformResult> transform_cache;
+
+    for (auto & element : slots_) {
+      const TransformKey key(
+        element.header.frame_id,
+        rclcpp::Time(element.header.stamp).nanoseconds()
+      );
+      auto cached_transform = transform_cache.find(key);
+
+      if (cached_transform == transform_cache.end()) {
+        TransformResult result;
+        result.is_transformed = frame_manager.getTransform(
+          element.header,
+          result.position,
+          result.orientation
+        );
+        cached_transform = transform_cache.emplace(key, result).first;
+      }
+      const auto & frame_transform = cached_transform->second;
+
+      element.is_transformed = frame_transform.is_transformed;
+
+      if (element.is_anchored) {
+        const auto & anchor_pose = element.anchor_pose;
+
+        element.position = frame_transform.position + frame_transform.orientation *
+          Ogre::Vector3(anchor_pose.position.x, anchor_pose.position.y, anchor_pose.position.z);
+        element.orientation = frame_transform.orientation * Ogre::Quaternion(
+          anchor_pose.orientation.w,
+          anchor_pose.orientation.x,
+          anchor_pose.orientation.y,
+          anchor_pose.orientation.z
+        );
+      } else {
+        element.position = frame_transform.position;
+        element.orientation = frame_transform.orientation;
+      }
+    }
+    return transform_cache.size();
+  }
+
+  //! Slot holding the state at an index counted from the oldest state
+  std::size_t slotOf(std::size_t index) const
+  {
+    return (oldest_slot_ + index) % slots_.size();
+  }
+
+  const Element & operator[](std::size_t index) const
+  {
+    return slots_[slotOf(index)];
+  }
+
+  const Element & back() const
+  {
+    return (*this)[slots_.size() - 1];
+  }
+
+private:
+  std::size_t capacity_;
+  std::vector<Element> slots_;
+  std::size_t oldest_slot_;
+
+  std::size_t write(Element && element)
+  {
+    if (slots_.size() < capacity_) {
+      slots_.push_back(std::move(element));
+      return slots_.size() - 1;
+    }
+    const std::size_t slot = oldest_slot_;
+    slots_[slot] = std::move(element);
+    oldest_slot_ = (oldest_slot_ + 1) % slots_.size();
+    return slot;
+  }
+};
+}  // namespace geometry_rviz_plugins::history
+#endif  // GEOMETRY_RVIZ_PLUGINS__HISTORY__RETAINED_HISTORY_HPP_
@@ -0,0 +1,47 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__MATH__SYMMETRIC_EIGEN3_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__MATH__SYMMETRIC_EIGEN3_HPP_
+
+#include <array>
+
+
+namespace geometry_rviz_plugins::math
+{
+using Vector3d = std::array<double, 3>;
+//! Row major 3x3 matrix
+using Matrix3d = std::array<double, 9>;
+
+struct SymmetricEigen3
+{
+  //! Sorted in descending order
+  Vector3d eigenvalues;
+  //! Orthonormal right handed basis, eigenvectors[i] belongs to eigenvalues[i]
+  std::array<Vector3d, 3> eigenvectors;
+};
+
+/**
+ * Closed form eigen decomposition of a symmetric 3x3 matrix.
+ * Only the upper triangle of the matrix is read.
+ */
+SymmetricEigen3 solveSymmetricEigen3(const Matrix3d &);
+}  // namespace geometry_rviz_plugins::math
+#endif  // GEOMETRY_RVIZ_PLUGINS__MATH__SYMMETRIC_EIGEN3_HPP_
@@ -0,0 +1,137 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__RENDERING__MAGNITUDE_LABEL_BATCH_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__RENDERING__MAGNITUDE_LABEL_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <OgreBillboard.h>
+#include <OgreBillboardSet.h>
+#include <OgreColourValue.h>
+#include <OgreFont.h>
+#include <OgreImage.h>
+#include <OgreMaterial.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreTexture.h>
+#include <OgreVector.h>
+
+
+namespace geometry_rviz_plugins::rendering
+{
+/**
+ * Numeric labels drawn as camera facing billboards of a single set.
+ *
+ * Each distinct text is rendered once from the glyphs of an Ogre font into
+ * a cell of a shared text atlas, and every label is one billboard showing
+ * its cell. Ogre faces the billboards to the camera, so camera motion costs
+ * nothing here. A label is formatted again only when its value changes at
+ * the precision, and labels showing the same text share the cell.
+ */
+class MagnitudeLabelBatch
+{
+public:
+  MagnitudeLabelBatch(
+    Ogre::SceneManager *,
+    Ogre::SceneNode * parent_node,
+    const std::string & font_name = "Liberation Sans"
+  );
+  ~MagnitudeLabelBatch();
+
+  MagnitudeLabelBatch(const MagnitudeLabelBatch &) = delete;
+  MagnitudeLabelBatch & operator=(const MagnitudeLabelBatch &) = delete;
+
+  void setFormat(int precision, const std::string & unit);
+  void setCharacterHeight(float);
+  void setColor(float r, float g, float b, float a);
+
+  void resize(std::size_t);
+  void setLabel(std::size_t index, double value, const Ogre::Vector3 & position);
+  void setLabelVisible(std::size_t index, bool);
+
+private:
+  static constexpr std::size_t no_cell_ = static_cast<std::size_t>(-1);
+
+  struct TextCell
+  {
+    std::string text;
+    std::size_t reference_count;
+    bool is_queued_unused;
+  };
+
+  struct Label
+  {
+    bool has_value,
+      is_visible,
+      is_shown;
+    long long quantized_value;  // NOLINT
+    std::size_t cell;
+    Ogre::Billboard * billboard;
+  };
+
+  Ogre::SceneManager * scene_manager_;
+  Ogre::SceneNode * scene_node_;
+  Ogre::BillboardSet * billboard_set_;
+
+  std::string name_;
+  Ogre::FontPtr font_;
+  Ogre::Image font_image_;
+  Ogre::TexturePtr atlas_texture_;
+  Ogre::MaterialPtr material_;
+
+  std::size_t cell_width_,
+    cell_height_,
+    space_width_,
+    atlas_column_count_,
+    atlas_row_count_,
+    max_atlas_row_count_,
+    atlas_generation_;
+  std::vector<std::uint8_t> blank_cell_;
+
+  std::vector<TextCell> cells_;
+  std::unordered_map<std::string, std::size_t> cell_of_text_;
+  std::deque<std::size_t> unused_cells_;
+
+  int precision_;
+  double quantization_scale_;
+  std::string unit_;
+  float character_height_;
+  Ogre::ColourValue color_;
+
+  std::vector<Label> labels_;
+
+  std::size_t acquireCell(const std::string & text);
+  void releaseCell(std::size_t cell);
+  bool growAtlas();
+  void createAtlasTexture();
+  void renderCell(std::size_t cell);
+  Ogre::FloatRect cellTexcoords(std::size_t cell) const;
+
+  void updateLabelVisibility(Label &);
+};
+}  // namespace geometry_rviz_plugins::rendering
+#endif  // GEOMETRY_RVIZ_PLUGINS__RENDERING__MAGNITUDE_LABEL_BATCH_HPP_
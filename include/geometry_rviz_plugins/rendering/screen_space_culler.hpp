@@ -0,0 +1,77 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__RENDERING__SCREEN_SPACE_CULLER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__RENDERING__SCREEN_SPACE_CULLER_HPP_
+
+#include <cstdint>
+
+#include <unordered_map>
+
+#include <OgreCamera.h>
+#include <OgreMatrix4.h>
+#include <OgreSphere.h>
+
+
+namespace geometry_rviz_plugins::rendering
+{
+struct ScreenSpaceCullingProperties
+{
+  bool is_frustum_culling_enabled,
+    is_thinning_enabled;
+  float cell_size;
+  int max_count_per_cell;
+};
+
+/**
+ * Decides which objects are worth converting for the current camera.
+ * Objects outside the view frustum are rejected, and with thinning at most
+ * a fixed number of objects is accepted per screen grid cell, in call order.
+ */
+class ScreenSpaceCuller
+{
+public:
+  ScreenSpaceCuller();
+
+  //! Returns true when the camera view or projection changed since the last call
+  bool updateCamera(const Ogre::Camera &);
+
+  void begin(const Ogre::Camera &, const ScreenSpaceCullingProperties &);
+  bool accept(const Ogre::Sphere &);
+
+  //! Forgets the camera and frees the grid cells
+  void release();
+
+private:
+  const Ogre::Camera * camera_;
+  ScreenSpaceCullingProperties properties_;
+
+  Ogre::Matrix4 view_matrix_,
+    view_projection_matrix_;
+  float viewport_width_,
+    viewport_height_;
+
+  Ogre::Matrix4 last_view_matrix_,
+    last_projection_matrix_;
+
+  std::unordered_map<std::uint64_t, int> cell_counts_;
+};
+}  // namespace geometry_rviz_plugins::rendering
+#endif  // GEOMETRY_RVIZ_PLUGINS__RENDERING__SCREEN_SPACE_CULLER_HPP_
@@ -0,0 +1,64 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__CDR_READER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__CDR_READER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+
+namespace geometry_rviz_plugins::serialization
+{
+/**
+ * Reads primitives in place from a CDR encapsulated buffer.
+ * Every read is bounds checked, and once a read fails the reader stays failed.
+ */
+class CdrReader
+{
+public:
+  CdrReader(const std::uint8_t * buffer, std::size_t length);
+
+  bool ok() const;
+
+  bool readInt32(std::int32_t &);
+  bool readUint32(std::uint32_t &);
+  bool readDouble(double &);
+  //! Assigns into the given string, reusing its capacity
+  bool readString(std::string &);
+
+  bool skipDoubles(std::size_t count);
+
+private:
+  static constexpr std::size_t encapsulation_size_ = 4;
+
+  const std::uint8_t * buffer_;
+  std::size_t length_,
+    offset_;
+  bool is_swap_required_,
+    is_ok_;
+
+  bool align(std::size_t size);
+  bool readBytes(void * destination, std::size_t size);
+};
+}  // namespace geometry_rviz_plugins::serialization
+#endif  // GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__CDR_READER_HPP_
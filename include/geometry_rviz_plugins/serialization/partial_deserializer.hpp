@@ -0,0 +1,59 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__PARTIAL_DESERIALIZER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__PARTIAL_DESERIALIZER_HPP_
+
+#include <rclcpp/serialized_message.hpp>
+
+#include <std_msgs/msg/header.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <geometry_msgs/msg/vector3.hpp>
+
+#include <geometry_rviz_plugins/math/symmetric_eigen3.hpp>
+
+
+namespace geometry_rviz_plugins::serialization
+{
+// Decode only the fields the displays draw straight from the CDR buffer,
+// without constructing the message. Unused payload is skipped.
+
+bool deserializeVector3Stamped(
+  const rclcpp::SerializedMessage &,
+  std_msgs::msg::Header &,
+  geometry_msgs::msg::Vector3 &
+);
+
+bool deserializeTwistStamped(
+  const rclcpp::SerializedMessage &,
+  std_msgs::msg::Header &,
+  geometry_msgs::msg::Twist &
+);
+
+//! Only the linear and angular diagonal blocks of the covariance are read
+bool deserializeTwistWithCovarianceStamped(
+  const rclcpp::SerializedMessage &,
+  std_msgs::msg::Header &,
+  geometry_msgs::msg::Twist &,
+  math::Matrix3d & linear_covariance,
+  math::Matrix3d & angular_covariance
+);
+}  // namespace geometry_rviz_plugins::serialization
+#endif  // GEOMETRY_RVIZ_PLUGINS__SERIALIZATION__PARTIAL_DESERIALIZER_HPP_
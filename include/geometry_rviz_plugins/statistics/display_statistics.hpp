@@ -0,0 +1,130 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__STATISTICS__DISPLAY_STATISTICS_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__STATISTICS__DISPLAY_STATISTICS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+namespace geometry_rviz_plugins::statistics
+{
+class ExponentialMovingAverage
+{
+public:
+  explicit ExponentialMovingAverage(double smoothing_factor);
+
+  void reset();
+  void add(double);
+  double value() const;
+
+private:
+  const double smoothing_factor_;
+
+  bool has_value_;
+  double value_;
+};
+
+class ExponentialMovingRate
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit ExponentialMovingRate(double smoothing_factor);
+
+  void reset();
+  void tick(const Clock::time_point &);
+  double rate(const Clock::time_point &) const;
+
+private:
+  const double smoothing_factor_;
+
+  bool has_last_tick_;
+  double average_interval_;
+  Clock::time_point last_tick_;
+};
+
+class DisplayStatistics
+{
+public:
+  using Clock = ExponentialMovingRate::Clock;
+
+  explicit DisplayStatistics(double smoothing_factor = 0.1);
+
+  void reset();
+
+  void countReceived(const Clock::time_point &);
+  void countRejected();
+  void countCoalesced();
+  void countRendered(const Clock::time_point &);
+
+  void addProcessingTime(const Clock::duration &);
+  void addFrameTime(const Clock::duration &);
+
+  //! Startup and first message timing are kept across reset()
+  void addStartupTime(const Clock::duration &);
+  void markEnabled(const Clock::time_point &);
+
+  std::uint64_t received() const;
+  std::uint64_t rejected() const;
+  std::uint64_t coalesced() const;
+  std::uint64_t rendered() const;
+
+  double receivedRate(const Clock::time_point &) const;
+  double renderedRate(const Clock::time_point &) const;
+
+  //! Average time spent per received message in seconds
+  double processingTime() const;
+  //! Average time spent per display update in seconds
+  double frameTime() const;
+
+  //! Time spent constructing and initializing the display in seconds
+  double startupTime() const;
+  bool hasFirstMessage() const;
+  //! Time from enabling the display to its first message in seconds
+  double firstMessageTime() const;
+
+  std::string toString(const Clock::time_point &) const;
+
+private:
+  // Rejections are reported from the message filter callback,
+  // which is not guaranteed to run in the rendering thread.
+  std::atomic<std::uint64_t> received_,
+    rejected_,
+    coalesced_,
+    rendered_;
+
+  ExponentialMovingRate received_rate_,
+    rendered_rate_;
+
+  ExponentialMovingAverage processing_time_,
+    frame_time_;
+
+  Clock::duration startup_time_;
+  Clock::time_point enabled_time_;
+  bool is_awaiting_first_message_,
+    has_first_message_;
+  Clock::duration first_message_time_;
+};
+}  // namespace geometry_rviz_plugins::statistics
+#endif  // GEOMETRY_RVIZ_PLUGINS__STATISTICS__DISPLAY_STATISTICS_HPP_
@@ -0,0 +1,51 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_PUBLISHER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_PUBLISHER_HPP_
+
+#include <string>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+#include "display_statistics.hpp"
+
+
+namespace geometry_rviz_plugins::statistics
+{
+class StatisticsPublisher
+{
+public:
+  StatisticsPublisher(rclcpp::Node::SharedPtr, const std::string & topic_name);
+
+  void publish(
+    const std::string & display_name,
+    const DisplayStatistics &,
+    const DisplayStatistics::Clock::time_point &
+  );
+
+private:
+  rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr publisher_;
+};
+}  // namespace geometry_rviz_plugins::statistics
+#endif  // GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_PUBLISHER_HPP_
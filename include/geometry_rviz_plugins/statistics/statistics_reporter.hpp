@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_REPORTER_HPP_
+#define GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_REPORTER_HPP_
+
+#include <memory>
+
+#include <QObject>
+
+#include <rviz_common/display.hpp>
+#include <rviz_common/properties/bool_property.hpp>
+#include <rviz_common/properties/string_property.hpp>
+#include <rviz_common/ros_integration/ros_node_abstraction_iface.hpp>
+
+#include "display_statistics.hpp"
+#include "statistics_publisher.hpp"
+
+
+namespace geometry_rviz_plugins::statistics
+{
+/**
+ * Statistics properties of a display and the report of its statistics.
+ *
+ * The report updates the "Statistics" status of the display at most once
+ * per second and publishes it as diagnostics when enabled by the property.
+ */
+class StatisticsReporter : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsReporter(rviz_common::Display *, const DisplayStatistics &);
+  ~StatisticsReporter() override;
+
+  //! The publisher only exists between enable() and disable()
+  void enable(rviz_common::ros_integration::RosNodeAbstractionIface::WeakPtr);
+  void disable();
+
+  void report();
+
+private Q_SLOTS:
+  void publisherPropertyCallback();
+
+private:
+  rviz_common::Display * display_;
+  const DisplayStatistics & display_statistics_;
+
+  std::unique_ptr<rviz_common::properties::BoolProperty> publish_statistics_property_;
+  std::unique_ptr<rviz_common::properties::StringProperty> statistics_topic_property_;
+
+  rviz_common::ros_integration::RosNodeAbstractionIface::WeakPtr ros_node_;
+  std::unique_ptr<StatisticsPublisher> statistics_publisher_;
+  DisplayStatistics::Clock::time_point last_report_time_;
+};
+}  // namespace geometry_rviz_plugins::statistics
+#endif  // GEOMETRY_RVIZ_PLUGINS__STATISTICS__STATISTICS_REPORTER_HPP_
@@ -22,6 +22,8 @@
 
 #include <cmath>
 
+#include <algorithm>
+
 
 namespace geometry_rviz_plugins::converter
 {
@@ -56,4 +58,27 @@ void rvizArrowConverter(
     quaternion * vector
   );
 }
+
+Ogre::Sphere rvizArrowBoundingSphere(
+  const geometry_msgs::msg::Vector3 & msg,
+  const Ogre::Vector3 & position,
+  const Ogre::Quaternion & quaternion,
+  const ConvertArrowProperties & convert_arrow_properties
+)
+{
+  const Ogre::Vector3 vector = convert_arrow_properties.arrow_scale * Ogre::Vector3(
+    msg.x,
+    msg.y,
+    msg.z
+  );
+  const float radius = 0.5f * vector.length() + std::max(
+    convert_arrow_properties.head_radius,
+    convert_arrow_properties.shaft_radius
+  );
+
+  return Ogre::Sphere(
+    position + quaternion * (0.5f * vector),
+    radius
+  );
+}
 }  // namespace geometry_rviz_plugins::converter
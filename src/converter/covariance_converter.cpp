@@ -0,0 +1,84 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/converter/covariance_converter.hpp>
+
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+
+
+namespace geometry_rviz_plugins::converter
+{
+math::Matrix3d covarianceBlock(const std::array<double, 36> & covariance, int offset)
+{
+  math::Matrix3d block;
+
+  for (int row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      block[row * 3 + column] = covariance[(offset + row) * 6 + offset + column];
+    }
+  }
+  return block;
+}
+
+void rvizCovarianceConverter(
+  rviz_rendering::Shape & rviz_shape,
+  const geometry_msgs::msg::Vector3 & mean,
+  const math::Matrix3d & covariance,
+  const Ogre::Vector3 & position,
+  const Ogre::Quaternion & quaternion,
+  const ConvertCovarianceProperties & convert_covariance_properties
+)
+{
+  const math::SymmetricEigen3 eigen = math::solveSymmetricEigen3(covariance);
+
+  // Unit sphere mesh has a diameter of 1, scale by twice the deviation
+  const float scale = 2 * convert_covariance_properties.arrow_scale *
+    convert_covariance_properties.deviation_scale;
+
+  Ogre::Vector3 axes[3];
+  Ogre::Vector3 radii;
+
+  for (int i = 0; i < 3; ++i) {
+    axes[i] = Ogre::Vector3(
+      eigen.eigenvectors[i][0],
+      eigen.eigenvectors[i][1],
+      eigen.eigenvectors[i][2]
+    );
+    radii[i] = scale * std::sqrt(std::max(eigen.eigenvalues[i], 0.0));
+  }
+
+  const Ogre::Vector3 vector = Ogre::Vector3(
+    mean.x,
+    mean.y,
+    mean.z
+  );
+
+  rviz_shape.setPosition(
+    position + quaternion * (convert_covariance_properties.arrow_scale * vector)
+  );
+  rviz_shape.setOrientation(
+    quaternion * Ogre::Quaternion(axes[0], axes[1], axes[2])
+  );
+  rviz_shape.setScale(radii);
+}
+}  // namespace geometry_rviz_plugins::converter
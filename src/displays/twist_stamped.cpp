@@ -20,10 +20,19 @@
 
 #include <geometry_rviz_plugins/displays/twist_stamped.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <string>
 
+#include <rclcpp/exceptions.hpp>
+
+#include <rviz_common/view_controller.hpp>
+#include <rviz_common/view_manager.hpp>
 #include <pluginlib/class_list_macros.hpp>
 
+#include <geometry_rviz_plugins/serialization/partial_deserializer.hpp>
+
 
 namespace geometry_rviz_plugins::displays
 {
@@ -37,14 +46,20 @@ TwistStampedDisplay::TwistStampedDisplay()
   default_angular_shaft_radius_(0.05),
   default_angular_head_radius_(0.1),
   default_angular_head_scale_(0.4),
-  default_angular_arrow_scale_(1.0)
+  default_angular_arrow_scale_(1.0),
+  has_anchor_mismatch_(false),
+  unrendered_count_(0),
+  is_rendering_dirty_(false)
 {
+  const auto construct_start_time = statistics::DisplayStatistics::Clock::now();
+
   linear_color_property_.reset(
     new rviz_common::properties::ColorProperty(
       "Linear Arrow Color",
       QColor(150, 200, 150),
       "Color to draw the twist linear vector arrow.",
-      this
+      this,
+      SLOT(linearPropertyCallback())
     )
   );
   linear_color_alpha_property_.reset(
@@ -52,7 +67,8 @@ TwistStampedDisplay::TwistStampedDisplay()
       "Linear Color Alpha",
       default_linear_color_alpha_,
       "Twist linear arrow transparency.",
-      this
+      this,
+      SLOT(linearPropertyCallback())
     )
   );
   linear_color_alpha_property_->setMin(0);
@@ -108,7 +124,8 @@ TwistStampedDisplay::TwistStampedDisplay()
       "Angular Arrow Color",
       QColor(100, 100, 200),
       "Color to draw the twist angular vector arrow.",
-      this
+      this,
+      SLOT(angularPropertyCallback())
     )
   );
   angular_color_alpha_property_.reset(
@@ -116,7 +133,8 @@ TwistStampedDisplay::TwistStampedDisplay()
       "Angular Color Alpha",
       default_angular_color_alpha_,
       "Twist angular arrow transparency.",
-      this
+      this,
+      SLOT(angularPropertyCallback())
     )
   );
   angular_color_alpha_property_->setMin(0);
@@ -166,6 +184,223 @@ TwistStampedDisplay::TwistStampedDisplay()
     )
   );
   angular_arrow_scale_property_->setMin(0);
+
+  history_length_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "History Length",
+      1,
+      "Number of twists to keep and draw.",
+      this,
+      SLOT(historyPropertyCallback())
+    )
+  );
+  history_length_property_->setMin(1);
+  history_length_property_->setMax(100000);
+
+  filter_type_property_.reset(
+    new rviz_common::properties::EnumProperty(
+      "Filter",
+      "None",
+      "Temporal filter applied to the incoming twists.",
+      this,
+      SLOT(filterPropertyCallback())
+    )
+  );
+  filter_type_property_->addOption("None", static_cast<int>(filter::FilterType::NONE));
+  filter_type_property_->addOption("Low Pass", static_cast<int>(filter::FilterType::LOW_PASS));
+  filter_type_property_->addOption(
+    "Moving Average",
+    static_cast<int>(filter::FilterType::MOVING_AVERAGE)
+  );
+  filter_type_property_->addOption("Median", static_cast<int>(filter::FilterType::MEDIAN));
+
+  filter_window_size_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Window Size",
+      10,
+      "Number of samples of the moving average and median windows.",
+      filter_type_property_.get(),
+      SLOT(filterPropertyCallback()),
+      this
+    )
+  );
+  filter_window_size_property_->setMin(1);
+  filter_window_size_property_->setMax(10000);
+
+  filter_smoothing_factor_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Smoothing Factor",
+      0.2,
+      "Weight of the newest sample in the low pass filter.",
+      filter_type_property_.get(),
+      SLOT(filterPropertyCallback()),
+      this
+    )
+  );
+  filter_smoothing_factor_property_->setMin(0.001);
+  filter_smoothing_factor_property_->setMax(1);
+
+  lazy_deserialization_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Lazy Deserialization",
+      false,
+      "Subscribe to the serialized message and decode only the header and twist.",
+      this,
+      SLOT(lazyDeserializationPropertyCallback())
+    )
+  );
+
+  anchor_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Pose Anchor",
+      false,
+      "Draw the arrows at the pose matched by stamp instead of the twist frame origin.",
+      this,
+      SLOT(anchorPropertyCallback())
+    )
+  );
+  anchor_type_property_.reset(
+    new rviz_common::properties::EnumProperty(
+      "Type",
+      "PoseStamped",
+      "Message type of the anchor topic.",
+      anchor_property_.get(),
+      SLOT(anchorPropertyCallback()),
+      this
+    )
+  );
+  anchor_type_property_->addOption("PoseStamped", 0);
+  anchor_type_property_->addOption("Odometry", 1);
+
+  anchor_topic_property_.reset(
+    new rviz_common::properties::RosTopicProperty(
+      "Topic",
+      "",
+      "geometry_msgs/msg/PoseStamped",
+      "Pose or odometry topic to anchor the arrows.",
+      anchor_property_.get(),
+      SLOT(anchorPropertyCallback()),
+      this
+    )
+  );
+  anchor_tolerance_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Tolerance",
+      0.05,
+      "Maximum stamp difference in seconds between a twist and its anchor pose.",
+      anchor_property_.get()
+    )
+  );
+  anchor_tolerance_property_->setMin(0);
+
+  anchor_buffer_length_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Buffer Length",
+      100,
+      "Number of anchor poses kept for matching.",
+      anchor_property_.get(),
+      SLOT(anchorBufferPropertyCallback()),
+      this
+    )
+  );
+  anchor_buffer_length_property_->setMin(1);
+  anchor_buffer_length_property_->setMax(10000);
+
+  frustum_culling_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Frustum Culling",
+      false,
+      "Skip converting arrows outside of the camera view.",
+      this,
+      SLOT(cullingPropertyCallback())
+    )
+  );
+  screen_thinning_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Screen Thinning",
+      false,
+      "Limit the number of arrows drawn per screen grid cell, newest first.",
+      this,
+      SLOT(cullingPropertyCallback())
+    )
+  );
+  thinning_cell_size_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Cell Size",
+      32,
+      "Screen grid cell size in pixels.",
+      screen_thinning_property_.get(),
+      SLOT(cullingPropertyCallback()),
+      this
+    )
+  );
+  thinning_cell_size_property_->setMin(1);
+
+  thinning_cell_count_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Max Arrows Per Cell",
+      1,
+      "Number of arrows drawn at most per screen grid cell.",
+      screen_thinning_property_.get(),
+      SLOT(cullingPropertyCallback()),
+      this
+    )
+  );
+  thinning_cell_count_property_->setMin(1);
+
+  magnitude_label_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Magnitude Label",
+      false,
+      "Draw the linear and angular speed next to each arrow.",
+      this,
+      SLOT(magnitudeLabelPropertyCallback())
+    )
+  );
+  magnitude_label_precision_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Precision",
+      2,
+      "Number of decimal places of the speed.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+  magnitude_label_precision_property_->setMin(0);
+  magnitude_label_precision_property_->setMax(6);
+
+  magnitude_label_height_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Character Height",
+      0.1,
+      "Height of the magnitude label characters.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+  magnitude_label_height_property_->setMin(0);
+
+  magnitude_label_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Color",
+      QColor(255, 255, 255),
+      "Color to draw the magnitude label.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+
+  initializeStatisticsProperties();
+
+  updateCullingLocalProperties();
+  updateFilterLocalProperties();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - construct_start_time
+  );
 }
 
 TwistStampedDisplay::TwistStampedDisplay(rviz_common::DisplayContext * context)
@@ -173,12 +408,9 @@ TwistStampedDisplay::TwistStampedDisplay(rviz_common::DisplayContext * context)
 {
   this->context_ = context;
   this->scene_manager_ = context->getSceneManager();
-  this->scene_node_ = this->scene_manager_->getRootSceneNode()->createChildSceneNode();
 
   updateLinearArrowLocalProperties();
   updateAngularArrowLocalProperties();
-
-  initializeRenderingObjects();
 }
 
 TwistStampedDisplay::~TwistStampedDisplay()
@@ -193,66 +425,521 @@ void TwistStampedDisplay::reset()
   updateLinearArrowLocalProperties();
   updateAngularArrowLocalProperties();
 
-  initializeRenderingObjects();
+  history_.clear();
+  anchor_buffer_.clear();
+  has_anchor_mismatch_ = false;
+  linear_filter_.reset();
+  angular_filter_.reset();
+  unrendered_count_ = 0;
+  is_rendering_dirty_ = false;
+  display_statistics_.reset();
+
+  IMFDClass::reset();
+}
+
+void TwistStampedDisplay::update(float wall_dt, float ros_dt)
+{
+  const auto update_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::update(wall_dt, ros_dt);
+
+  // Visibility depends on the view, so a moving camera requires a visibility pass
+  Ogre::Camera * camera = getCurrentCamera();
+  const bool is_view_changed =
+    camera && isCullingEnabled() && screen_space_culler_.updateCamera(*camera);
+
+  if (unrendered_count_ > 0 || is_rendering_dirty_ || is_view_changed) {
+    // Thinning ranks every twist against the newer ones, so it visits every slot too.
+    // Only slots that are new, dirty or stale and now visible are converted.
+    const bool is_full_pass =
+      is_rendering_dirty_ || is_view_changed || culling_properties_.is_thinning_enabled;
 
-  MFDClass::reset();
+    updateHistoryRendering(
+      is_full_pass ? history_.size() : unrendered_count_,
+      is_rendering_dirty_ ? history_.size() : unrendered_count_
+    );
+
+    if (unrendered_count_ > 0) {
+      display_statistics_.countRendered(update_start_time);
+    }
+    unrendered_count_ = 0;
+    is_rendering_dirty_ = false;
+  }
+
+  display_statistics_.addFrameTime(
+    statistics::DisplayStatistics::Clock::now() - update_start_time
+  );
+  reportStatistics();
 }
 
 void TwistStampedDisplay::processMessage(geometry_msgs::msg::TwistStamped::ConstSharedPtr msg)
 {
+  processTwist(msg->header, msg->twist);
+}
+
+void TwistStampedDisplay::processTwist(
+  const std_msgs::msg::Header & header,
+  const geometry_msgs::msg::Twist & twist
+)
+{
+  const auto receive_time = statistics::DisplayStatistics::Clock::now();
+  display_statistics_.countReceived(receive_time);
+
   Ogre::Vector3 ogre_position;
   Ogre::Quaternion ogre_quaternion;
 
-  const bool is_transformable_frame = this->context_->getFrameManager()->getTransform(
-    msg->header,
-    ogre_position,
-    ogre_quaternion
-  );
+  const history::AnchorPose * anchor = nullptr;
+
+  if (isAnchorEnabled()) {
+    anchor = anchor_buffer_.findNearest(
+      rclcpp::Time(header.stamp).nanoseconds(),
+      static_cast<std::int64_t>(anchor_tolerance_property_->getFloat() * 1e9)
+    );
+
+    if (!anchor) {
+      display_statistics_.countRejected();
+
+      if (!has_anchor_mismatch_) {
+        has_anchor_mismatch_ = true;
+        this->setStatusStd(
+          rviz_common::properties::StatusProperty::Warn,
+          "Anchor",
+          "No anchor pose within the tolerance of the twist stamp."
+        );
+      }
+      return;
+    }
+    if (has_anchor_mismatch_) {
+      has_anchor_mismatch_ = false;
+      this->setStatusStd(rviz_common::properties::StatusProperty::Ok, "Anchor", "OK");
+    }
+  }
+  bool is_transformable_frame;
+
+  if (anchor) {
+    is_transformable_frame = this->context_->getFrameManager()->transform(
+      anchor->header,
+      anchor->pose,
+      ogre_position,
+      ogre_quaternion
+    );
+  } else {
+    is_transformable_frame = this->context_->getFrameManager()->getTransform(
+      header,
+      ogre_position,
+      ogre_quaternion
+    );
+  }
 
   if (!is_transformable_frame) {
-    this->setMissingTransformToFixedFrame(msg->header.frame_id);
+    display_statistics_.countRejected();
+    this->setMissingTransformToFixedFrame(anchor ? anchor->header.frame_id : header.frame_id);
     return;
   }
   this->setTransformOk();
 
+  geometry_msgs::msg::Twist filtered_twist;
+  filtered_twist.linear = linear_filter_.filter(header.frame_id, twist.linear);
+  filtered_twist.angular = angular_filter_.filter(header.frame_id, twist.angular);
 
-  updateTwistRendering(msg, ogre_position, ogre_quaternion);
+  if (anchor) {
+    history_.pushAnchored(
+      anchor->header,
+      anchor->pose,
+      filtered_twist,
+      ogre_position,
+      ogre_quaternion
+    );
+  } else {
+    history_.push(header, filtered_twist, ogre_position, ogre_quaternion);
+  }
+
+  // Twists pushed out of the history before being drawn are coalesced.
+  if (++unrendered_count_ > history_.size()) {
+    display_statistics_.countCoalesced();
+    unrendered_count_ = history_.size();
+  }
+
+  display_statistics_.addProcessingTime(
+    statistics::DisplayStatistics::Clock::now() - receive_time
+  );
 
   this->context_->queueRender();
 }
 
 void TwistStampedDisplay::onInitialize()
 {
-  MFDClass::onInitialize();
+  const auto initialize_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::onInitialize();
+
+  anchor_topic_property_->initialize(this->rviz_ros_node_);
+  updateAnchorTopicType();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - initialize_start_time
+  );
+}
+
+// Rendering objects and retained twists are created again by the first
+// message after the display is enabled, an idle display only holds its properties.
+void TwistStampedDisplay::onDisable()
+{
+  IMFDClass::onDisable();
+
+  screen_space_culler_.release();
+}
+
+void TwistStampedDisplay::processSerializedMessage(
+  const rclcpp::SerializedMessage & serialized_msg
+)
+{
+  const bool is_deserialized = serialization::deserializeTwistStamped(
+    serialized_msg,
+    serialized_header_,
+    serialized_twist_
+  );
+
+  updateDecodeStatus(is_deserialized);
+
+  if (!is_deserialized) {
+    return;
+  }
+  processTwist(serialized_header_, serialized_twist_);
+}
+
+void TwistStampedDisplay::subscribe()
+{
+  subscribeAnchor();
+
+  IMFDClass::subscribe();
+}
+
+void TwistStampedDisplay::unsubscribe()
+{
+  anchor_pose_subscription_.reset();
+  anchor_odometry_subscription_.reset();
+
+  IMFDClass::unsubscribe();
+}
+
+bool TwistStampedDisplay::isSerializedSubscription() const
+{
+  return lazy_deserialization_property_->getBool();
+}
+
+// Anchored twists only need the anchor pose frame, the message filter
+// would hold them back until their own frame can be transformed.
+bool TwistStampedDisplay::isUnfilteredSubscription() const
+{
+  return isSerializedSubscription() || isAnchorEnabled();
+}
+
+bool TwistStampedDisplay::isAnchorEnabled() const
+{
+  return anchor_property_->getBool() && !anchor_topic_property_->getTopicStd().empty();
+}
+
+void TwistStampedDisplay::subscribeAnchor()
+{
+  if (!this->isEnabled() || !isAnchorEnabled()) {
+    return;
+  }
+
+  try {
+    auto node = this->rviz_ros_node_.lock()->get_raw_node();
+
+    if (anchor_type_property_->getOptionInt() == 1) {
+      anchor_odometry_subscription_ = node->create_subscription<nav_msgs::msg::Odometry>(
+        anchor_topic_property_->getTopicStd(),
+        this->qos_profile,
+        [this](nav_msgs::msg::Odometry::ConstSharedPtr msg) {
+          processAnchorPose(msg->header, msg->pose.pose);
+        }
+      );
+    } else {
+      anchor_pose_subscription_ = node->create_subscription<geometry_msgs::msg::PoseStamped>(
+        anchor_topic_property_->getTopicStd(),
+        this->qos_profile,
+        [this](geometry_msgs::msg::PoseStamped::ConstSharedPtr msg) {
+          processAnchorPose(msg->header, msg->pose);
+        }
+      );
+    }
+    this->setStatus(rviz_common::properties::StatusProperty::Ok, "Anchor Topic", "OK");
+  } catch (const rclcpp::exceptions::InvalidTopicNameError & e) {
+    this->setStatus(
+      rviz_common::properties::StatusProperty::Error,
+      "Anchor Topic",
+      QString("Error subscribing: ") + e.what()
+    );
+  }
+}
+
+void TwistStampedDisplay::processAnchorPose(
+  const std_msgs::msg::Header & header,
+  const geometry_msgs::msg::Pose & pose
+)
+{
+  anchor_buffer_.push(header, pose);
+}
+
+void TwistStampedDisplay::updateAnchorTopicType()
+{
+  anchor_topic_property_->setMessageType(
+    anchor_type_property_->getOptionInt() == 1 ?
+    "nav_msgs/msg/Odometry" :
+    "geometry_msgs/msg/PoseStamped"
+  );
+}
+
+void TwistStampedDisplay::fixedFrameChanged()
+{
+  if (tf_filter_) {
+    tf_filter_->setTargetFrame(fixed_frame_.toStdString());
+  }
+  // Retained twists are kept in their source frame, so they are moved to
+  // the new fixed frame instead of being dropped by a reset.
+  history_.retransform(*this->context_->getFrameManager());
+  is_rendering_dirty_ = true;
+
+  this->context_->queueRender();
 }
 
 void TwistStampedDisplay::linearPropertyCallback()
 {
   updateLinearArrowLocalProperties();
+
+  // Labels share the arrow transparency
+  if (linear_magnitude_labels_) {
+    updateMagnitudeLabelProperties();
+  }
+
+  is_rendering_dirty_ = true;
 }
 
 void TwistStampedDisplay::angularPropertyCallback()
 {
   updateAngularArrowLocalProperties();
+
+  // Labels share the arrow transparency
+  if (linear_magnitude_labels_) {
+    updateMagnitudeLabelProperties();
+  }
+
+  is_rendering_dirty_ = true;
+}
+
+void TwistStampedDisplay::lazyDeserializationPropertyCallback()
+{
+  resubscribe();
+}
+
+void TwistStampedDisplay::anchorPropertyCallback()
+{
+  updateAnchorTopicType();
+
+  anchor_buffer_.clear();
+  has_anchor_mismatch_ = false;
+  this->deleteStatusStd("Anchor");
+  this->deleteStatusStd("Anchor Topic");
+
+  if (!this->isEnabled()) {
+    return;
+  }
+  unsubscribe();
+  subscribe();
+}
+
+void TwistStampedDisplay::anchorBufferPropertyCallback()
+{
+  anchor_buffer_.setCapacity(anchor_buffer_length_property_->getInt());
+}
+
+void TwistStampedDisplay::historyPropertyCallback()
+{
+  history_.setCapacity(history_length_property_->getInt());
+
+  if (unrendered_count_ > history_.size()) {
+    unrendered_count_ = history_.size();
+  }
+  is_rendering_dirty_ = true;
+}
+
+void TwistStampedDisplay::filterPropertyCallback()
+{
+  updateFilterLocalProperties();
+}
+
+void TwistStampedDisplay::magnitudeLabelPropertyCallback()
+{
+  if (linear_magnitude_labels_) {
+    updateMagnitudeLabelProperties();
+  }
+  is_rendering_dirty_ = true;
+}
+
+void TwistStampedDisplay::cullingPropertyCallback()
+{
+  updateCullingLocalProperties();
+
+  is_rendering_dirty_ = true;
+}
+
+// Updates the visibility of the newest visited twists, both arrows of a slot
+// are converted again only when it is visible and stale.
+void TwistStampedDisplay::updateHistoryRendering(
+  std::size_t visited_count,
+  std::size_t stale_count
+)
+{
+  ensureSceneNode();
+
+  resizeRenderingObjects(history_.size());
+
+  if (!magnitude_label_property_->getBool()) {
+    linear_magnitude_labels_.reset();
+    angular_magnitude_labels_.reset();
+  } else if (!linear_magnitude_labels_) {
+    linear_magnitude_labels_ = std::make_unique<rendering::MagnitudeLabelBatch>(
+      this->scene_manager_,
+      this->scene_node_
+    );
+    angular_magnitude_labels_ = std::make_unique<rendering::MagnitudeLabelBatch>(
+      this->scene_manager_,
+      this->scene_node_
+    );
+    updateMagnitudeLabelProperties();
+  }
+  if (linear_magnitude_labels_) {
+    linear_magnitude_labels_->resize(history_.size());
+    angular_magnitude_labels_->resize(history_.size());
+  }
+
+  Ogre::Camera * camera = getCurrentCamera();
+  const bool is_culling_enabled = camera && isCullingEnabled();
+
+  if (is_culling_enabled) {
+    screen_space_culler_.begin(*camera, culling_properties_);
+  }
+
+  for (std::size_t i = history_.size() - std::min(stale_count, history_.size());
+    i < history_.size(); ++i)
+  {
+    is_slot_converted_[history_.slotOf(i)] = false;
+  }
+  const std::size_t first_index = history_.size() - std::min(visited_count, history_.size());
+
+  // Newest first, so thinning keeps the latest twists of a crowded cell
+  for (std::size_t i = history_.size(); i-- > first_index; ) {
+    const std::size_t slot = history_.slotOf(i);
+    const auto & retained_twist = history_[i];
+
+    bool is_visible = retained_twist.is_transformed;
+
+    // Each sphere is centred on its own arrow, so the pair needs their union
+    if (is_visible && is_culling_enabled) {
+      Ogre::Sphere bounding_sphere = converter::rvizArrowBoundingSphere(
+        retained_twist.state.linear,
+        retained_twist.position,
+        retained_twist.orientation,
+        linear_arrow_properties_
+      );
+      bounding_sphere.merge(
+        converter::rvizArrowBoundingSphere(
+          retained_twist.state.angular,
+          retained_twist.position,
+          retained_twist.orientation,
+          angular_arrow_properties_
+        )
+      );
+      is_visible = screen_space_culler_.accept(bounding_sphere);
+    }
+    rviz_linear_arrows_[slot]->getSceneNode()->setVisible(is_visible);
+    rviz_angular_arrows_[slot]->getSceneNode()->setVisible(is_visible);
+
+    if (linear_magnitude_labels_) {
+      linear_magnitude_labels_->setLabelVisible(slot, is_visible);
+      angular_magnitude_labels_->setLabelVisible(slot, is_visible);
+    }
+    if (!is_visible || is_slot_converted_[slot]) {
+      continue;
+    }
+    is_slot_converted_[slot] = true;
+
+    updateTwistRendering(
+      *rviz_linear_arrows_[slot],
+      *rviz_angular_arrows_[slot],
+      retained_twist.state,
+      retained_twist.position,
+      retained_twist.orientation
+    );
+
+    if (linear_magnitude_labels_) {
+      converter::magnitudeLabelConverter(
+        *linear_magnitude_labels_,
+        slot,
+        retained_twist.state.linear,
+        retained_twist.position,
+        retained_twist.orientation,
+        linear_arrow_properties_
+      );
+      converter::magnitudeLabelConverter(
+        *angular_magnitude_labels_,
+        slot,
+        retained_twist.state.angular,
+        retained_twist.position,
+        retained_twist.orientation,
+        angular_arrow_properties_
+      );
+    }
+  }
+}
+
+void TwistStampedDisplay::updateMagnitudeLabelProperties()
+{
+  const int precision = magnitude_label_precision_property_->getInt();
+  const float character_height = magnitude_label_height_property_->getFloat();
+  const QColor label_color = magnitude_label_color_property_->getColor();
+
+  linear_magnitude_labels_->setFormat(precision, "m/s");
+  linear_magnitude_labels_->setCharacterHeight(character_height);
+  linear_magnitude_labels_->setColor(
+    label_color.redF(),
+    label_color.greenF(),
+    label_color.blueF(),
+    linear_color_alpha_property_->getFloat()
+  );
+
+  angular_magnitude_labels_->setFormat(precision, "rad/s");
+  angular_magnitude_labels_->setCharacterHeight(character_height);
+  angular_magnitude_labels_->setColor(
+    label_color.redF(),
+    label_color.greenF(),
+    label_color.blueF(),
+    angular_color_alpha_property_->getFloat()
+  );
 }
 
 void TwistStampedDisplay::updateTwistRendering(
-  const geometry_msgs::msg::TwistStamped::ConstSharedPtr msg,
+  rviz_rendering::Arrow & rviz_linear_arrow,
+  rviz_rendering::Arrow & rviz_angular_arrow,
+  const geometry_msgs::msg::Twist & twist,
   const Ogre::Vector3 & ogre_position,
   const Ogre::Quaternion & ogre_quaternion
 )
 {
   converter::rvizArrowConverter(
-    *rviz_linear_arrow_,
-    msg->twist.linear,
+    rviz_linear_arrow,
+    twist.linear,
     ogre_quaternion,
     linear_arrow_properties_
   );
-  rviz_linear_arrow_->setPosition(ogre_position);
+  rviz_linear_arrow.setPosition(ogre_position);
 
   const QColor linear_arrow_color = linear_color_property_->getColor();
 
-  rviz_linear_arrow_->setColor(
+  rviz_linear_arrow.setColor(
     linear_arrow_color.redF(),
     linear_arrow_color.greenF(),
     linear_arrow_color.blueF(),
@@ -260,16 +947,16 @@ void TwistStampedDisplay::updateTwistRendering(
   );
 
   converter::rvizArrowConverter(
-    *rviz_angular_arrow_,
-    msg->twist.angular,
+    rviz_angular_arrow,
+    twist.angular,
     ogre_quaternion,
     angular_arrow_properties_
   );
-  rviz_angular_arrow_->setPosition(ogre_position);
+  rviz_angular_arrow.setPosition(ogre_position);
 
   const QColor angular_arrow_color = angular_color_property_->getColor();
 
-  rviz_angular_arrow_->setColor(
+  rviz_angular_arrow.setColor(
     angular_arrow_color.redF(),
     angular_arrow_color.greenF(),
     angular_arrow_color.blueF(),
@@ -293,30 +980,91 @@ void TwistStampedDisplay::updateAngularArrowLocalProperties()
   angular_arrow_properties_.shaft_radius = angular_shaft_radius_property_->getFloat();
 }
 
-void TwistStampedDisplay::initializeRenderingObjects()
+void TwistStampedDisplay::resizeRenderingObjects(std::size_t size)
 {
-  rviz_linear_arrow_ = std::make_unique<rviz_rendering::Arrow>(
-    this->scene_manager_,
-    this->scene_node_
-  );
-  rviz_linear_arrow_->set(0, 0, 0, 0);
+  while (rviz_linear_arrows_.size() < size) {
+    rviz_linear_arrows_.push_back(
+      std::make_unique<rviz_rendering::Arrow>(
+        this->scene_manager_,
+        this->scene_node_
+      )
+    );
+    rviz_linear_arrows_.back()->set(0, 0, 0, 0);
 
-  rviz_angular_arrow_ = std::make_unique<rviz_rendering::Arrow>(
-    this->scene_manager_,
-    this->scene_node_
-  );
-  rviz_angular_arrow_->set(0, 0, 0, 0);
+    rviz_angular_arrows_.push_back(
+      std::make_unique<rviz_rendering::Arrow>(
+        this->scene_manager_,
+        this->scene_node_
+      )
+    );
+    rviz_angular_arrows_.back()->set(0, 0, 0, 0);
+  }
+  if (rviz_linear_arrows_.size() > size) {
+    rviz_linear_arrows_.resize(size);
+    rviz_angular_arrows_.resize(size);
+  }
+  is_slot_converted_.resize(size, false);
 }
 
-void TwistStampedDisplay::destroyRenderingObjects()
+// Displays built from a context get their scene node with the first rendering objects
+void TwistStampedDisplay::ensureSceneNode()
 {
-  if (rviz_linear_arrow_) {
-    rviz_linear_arrow_.reset();
+  if (!this->scene_node_) {
+    this->scene_node_ = this->scene_manager_->getRootSceneNode()->createChildSceneNode();
   }
+}
 
-  if (rviz_angular_arrow_) {
-    rviz_angular_arrow_.reset();
+void TwistStampedDisplay::destroyRenderingObjects()
+{
+  rviz_linear_arrows_.clear();
+  rviz_angular_arrows_.clear();
+  linear_magnitude_labels_.reset();
+  angular_magnitude_labels_.reset();
+  is_slot_converted_.clear();
+}
+
+void TwistStampedDisplay::updateCullingLocalProperties()
+{
+  culling_properties_.is_frustum_culling_enabled = frustum_culling_property_->getBool();
+  culling_properties_.is_thinning_enabled = screen_thinning_property_->getBool();
+  culling_properties_.cell_size = thinning_cell_size_property_->getFloat();
+  culling_properties_.max_count_per_cell = thinning_cell_count_property_->getInt();
+}
+
+// Changing the filter restarts it, retained states stay as they were filtered.
+void TwistStampedDisplay::updateFilterLocalProperties()
+{
+  const filter::TemporalFilterProperties filter_properties{
+    static_cast<filter::FilterType>(filter_type_property_->getOptionInt()),
+    static_cast<std::size_t>(filter_window_size_property_->getInt()),
+    filter_smoothing_factor_property_->getFloat()
+  };
+  linear_filter_.setProperties(filter_properties);
+  angular_filter_.setProperties(filter_properties);
+
+  filter_window_size_property_->setHidden(
+    filter_properties.type != filter::FilterType::MOVING_AVERAGE &&
+    filter_properties.type != filter::FilterType::MEDIAN
+  );
+  filter_smoothing_factor_property_->setHidden(
+    filter_properties.type != filter::FilterType::LOW_PASS
+  );
+}
+
+bool TwistStampedDisplay::isCullingEnabled() const
+{
+  return culling_properties_.is_frustum_culling_enabled ||
+         culling_properties_.is_thinning_enabled;
+}
+
+Ogre::Camera * TwistStampedDisplay::getCurrentCamera() const
+{
+  if (!this->context_ || !this->context_->getViewManager()) {
+    return nullptr;
   }
+  const auto view_controller = this->context_->getViewManager()->getCurrent();
+
+  return view_controller ? view_controller->getCamera() : nullptr;
 }
 }  // namespace geometry_rviz_plugins::displays
 
@@ -0,0 +1,594 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/displays/twist_with_covariance_stamped.hpp>
+
+#include <memory>
+
+#include <pluginlib/class_list_macros.hpp>
+
+#include <geometry_rviz_plugins/serialization/partial_deserializer.hpp>
+
+
+namespace geometry_rviz_plugins::displays
+{
+TwistWithCovarianceStampedDisplay::TwistWithCovarianceStampedDisplay()
+: default_linear_color_alpha_(1.0),
+  default_linear_shaft_radius_(0.05),
+  default_linear_head_radius_(0.1),
+  default_linear_head_scale_(0.4),
+  default_linear_arrow_scale_(1.0),
+  default_angular_color_alpha_(1.0),
+  default_angular_shaft_radius_(0.05),
+  default_angular_head_radius_(0.1),
+  default_angular_head_scale_(0.4),
+  default_angular_arrow_scale_(1.0),
+  default_covariance_color_alpha_(0.3),
+  default_covariance_deviation_scale_(1.0),
+  has_pending_twist_(false)
+{
+  const auto construct_start_time = statistics::DisplayStatistics::Clock::now();
+
+  linear_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Linear Arrow Color",
+      QColor(150, 200, 150),
+      "Color to draw the twist linear vector arrow.",
+      this
+    )
+  );
+  linear_color_alpha_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Linear Color Alpha",
+      default_linear_color_alpha_,
+      "Twist linear arrow transparency.",
+      this
+    )
+  );
+  linear_color_alpha_property_->setMin(0);
+  linear_color_alpha_property_->setMax(1);
+
+  linear_shaft_radius_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Linear Shaft Radius",
+      default_linear_shaft_radius_,
+      "Shaft radius of the linear arrow.",
+      this,
+      SLOT(linearPropertyCallback())
+    )
+  );
+  linear_shaft_radius_property_->setMin(0);
+
+  linear_head_radius_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Linear Head Radius",
+      default_linear_head_radius_,
+      "Head radius of the linear arrow.",
+      this,
+      SLOT(linearPropertyCallback())
+    )
+  );
+  linear_head_radius_property_->setMin(0);
+
+  linear_head_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Linear Head Scale",
+      default_linear_head_scale_,
+      "Head length scale of the twist linear arrow.",
+      this,
+      SLOT(linearPropertyCallback())
+    )
+  );
+  linear_head_scale_property_->setMin(0);
+  linear_head_scale_property_->setMax(1);
+
+  linear_arrow_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Linear Arrow Scale",
+      default_linear_arrow_scale_,
+      "Arrow scale of the twist linear.",
+      this,
+      SLOT(linearPropertyCallback())
+    )
+  );
+  linear_arrow_scale_property_->setMin(0);
+
+  linear_covariance_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Linear Covariance",
+      true,
+      "Draw the linear covariance as an ellipsoid at the arrow head.",
+      this,
+      SLOT(linearPropertyCallback())
+    )
+  );
+  linear_covariance_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Color",
+      QColor(150, 200, 150),
+      "Color to draw the linear covariance.",
+      linear_covariance_property_.get()
+    )
+  );
+  linear_covariance_alpha_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Alpha",
+      default_covariance_color_alpha_,
+      "Linear covariance transparency.",
+      linear_covariance_property_.get()
+    )
+  );
+  linear_covariance_alpha_property_->setMin(0);
+  linear_covariance_alpha_property_->setMax(1);
+
+  linear_covariance_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Scale",
+      default_covariance_deviation_scale_,
+      "Number of standard deviations drawn by the linear covariance.",
+      linear_covariance_property_.get(),
+      SLOT(linearPropertyCallback()),
+      this
+    )
+  );
+  linear_covariance_scale_property_->setMin(0);
+
+  angular_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Angular Arrow Color",
+      QColor(100, 100, 200),
+      "Color to draw the twist angular vector arrow.",
+      this
+    )
+  );
+  angular_color_alpha_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Angular Color Alpha",
+      default_angular_color_alpha_,
+      "Twist angular arrow transparency.",
+      this
+    )
+  );
+  angular_color_alpha_property_->setMin(0);
+  angular_color_alpha_property_->setMax(1);
+
+  angular_shaft_radius_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Angular Shaft Radius",
+      default_angular_shaft_radius_,
+      "Shaft radius of the angular arrow.",
+      this,
+      SLOT(angularPropertyCallback())
+    )
+  );
+  angular_shaft_radius_property_->setMin(0);
+
+  angular_head_radius_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Angular Head Radius",
+      default_angular_head_radius_,
+      "Head radius of the angular arrow.",
+      this,
+      SLOT(angularPropertyCallback())
+    )
+  );
+  angular_head_radius_property_->setMin(0);
+
+  angular_head_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Angular Head Scale",
+      default_angular_head_scale_,
+      "Head length scale of the twist angular arrow.",
+      this,
+      SLOT(angularPropertyCallback())
+    )
+  );
+  angular_head_scale_property_->setMin(0);
+  angular_head_scale_property_->setMax(1);
+
+  angular_arrow_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Angular Arrow Scale",
+      default_angular_arrow_scale_,
+      "Arrow scale of the twist angular.",
+      this,
+      SLOT(angularPropertyCallback())
+    )
+  );
+  angular_arrow_scale_property_->setMin(0);
+
+  angular_covariance_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Angular Covariance",
+      true,
+      "Draw the angular covariance as an ellipsoid at the arrow head.",
+      this,
+      SLOT(angularPropertyCallback())
+    )
+  );
+  angular_covariance_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Color",
+      QColor(100, 100, 200),
+      "Color to draw the angular covariance.",
+      angular_covariance_property_.get()
+    )
+  );
+  angular_covariance_alpha_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Alpha",
+      default_covariance_color_alpha_,
+      "Angular covariance transparency.",
+      angular_covariance_property_.get()
+    )
+  );
+  angular_covariance_alpha_property_->setMin(0);
+  angular_covariance_alpha_property_->setMax(1);
+
+  angular_covariance_scale_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Scale",
+      default_covariance_deviation_scale_,
+      "Number of standard deviations drawn by the angular covariance.",
+      angular_covariance_property_.get(),
+      SLOT(angularPropertyCallback()),
+      this
+    )
+  );
+  angular_covariance_scale_property_->setMin(0);
+
+  lazy_deserialization_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Lazy Deserialization",
+      false,
+      "Subscribe to the serialized message and decode only the header, "
+      "twist and diagonal covariance blocks.",
+      this,
+      SLOT(lazyDeserializationPropertyCallback())
+    )
+  );
+
+  initializeStatisticsProperties();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - construct_start_time
+  );
+}
+
+TwistWithCovarianceStampedDisplay::TwistWithCovarianceStampedDisplay(
+  rviz_common::DisplayContext * context
+)
+: TwistWithCovarianceStampedDisplay()
+{
+  this->context_ = context;
+  this->scene_manager_ = context->getSceneManager();
+
+  updateLinearArrowLocalProperties();
+  updateAngularArrowLocalProperties();
+}
+
+TwistWithCovarianceStampedDisplay::~TwistWithCovarianceStampedDisplay()
+{
+  destroyRenderingObjects();
+}
+
+void TwistWithCovarianceStampedDisplay::reset()
+{
+  destroyRenderingObjects();
+
+  updateLinearArrowLocalProperties();
+  updateAngularArrowLocalProperties();
+
+  has_pending_twist_ = false;
+  display_statistics_.reset();
+
+  IMFDClass::reset();
+}
+
+void TwistWithCovarianceStampedDisplay::update(float wall_dt, float ros_dt)
+{
+  const auto update_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::update(wall_dt, ros_dt);
+
+  if (has_pending_twist_) {
+    if (!rviz_linear_arrow_) {
+      ensureSceneNode();
+      initializeRenderingObjects();
+    }
+    updateTwistRendering();
+    has_pending_twist_ = false;
+
+    display_statistics_.countRendered(update_start_time);
+  }
+  display_statistics_.addFrameTime(
+    statistics::DisplayStatistics::Clock::now() - update_start_time
+  );
+  reportStatistics();
+}
+
+void TwistWithCovarianceStampedDisplay::processMessage(
+  geometry_msgs::msg::TwistWithCovarianceStamped::ConstSharedPtr msg
+)
+{
+  processTwist(
+    msg->header,
+    msg->twist.twist,
+    converter::covarianceBlock(msg->twist.covariance, 0),
+    converter::covarianceBlock(msg->twist.covariance, 3)
+  );
+}
+
+void TwistWithCovarianceStampedDisplay::processTwist(
+  const std_msgs::msg::Header & header,
+  const geometry_msgs::msg::Twist & twist,
+  const math::Matrix3d & linear_covariance,
+  const math::Matrix3d & angular_covariance
+)
+{
+  const auto receive_time = statistics::DisplayStatistics::Clock::now();
+  display_statistics_.countReceived(receive_time);
+
+  Ogre::Vector3 ogre_position;
+  Ogre::Quaternion ogre_quaternion;
+
+  const bool is_transformable_frame = this->context_->getFrameManager()->getTransform(
+    header,
+    ogre_position,
+    ogre_quaternion
+  );
+
+  if (!is_transformable_frame) {
+    display_statistics_.countRejected();
+    this->setMissingTransformToFixedFrame(header.frame_id);
+    return;
+  }
+  this->setTransformOk();
+
+  // Only the latest message is drawn per frame, older pending ones are coalesced.
+  if (has_pending_twist_) {
+    display_statistics_.countCoalesced();
+  }
+  has_pending_twist_ = true;
+  pending_twist_ = twist;
+  pending_linear_covariance_ = linear_covariance;
+  pending_angular_covariance_ = angular_covariance;
+  pending_position_ = ogre_position;
+  pending_quaternion_ = ogre_quaternion;
+
+  display_statistics_.addProcessingTime(
+    statistics::DisplayStatistics::Clock::now() - receive_time
+  );
+
+  this->context_->queueRender();
+}
+
+void TwistWithCovarianceStampedDisplay::onInitialize()
+{
+  const auto initialize_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::onInitialize();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - initialize_start_time
+  );
+}
+
+bool TwistWithCovarianceStampedDisplay::isSerializedSubscription() const
+{
+  return lazy_deserialization_property_->getBool();
+}
+
+void TwistWithCovarianceStampedDisplay::processSerializedMessage(
+  const rclcpp::SerializedMessage & serialized_msg
+)
+{
+  const bool is_deserialized = serialization::deserializeTwistWithCovarianceStamped(
+    serialized_msg,
+    serialized_header_,
+    serialized_twist_,
+    serialized_linear_covariance_,
+    serialized_angular_covariance_
+  );
+
+  updateDecodeStatus(is_deserialized);
+
+  if (!is_deserialized) {
+    return;
+  }
+  processTwist(
+    serialized_header_,
+    serialized_twist_,
+    serialized_linear_covariance_,
+    serialized_angular_covariance_
+  );
+}
+
+void TwistWithCovarianceStampedDisplay::linearPropertyCallback()
+{
+  updateLinearArrowLocalProperties();
+}
+
+void TwistWithCovarianceStampedDisplay::angularPropertyCallback()
+{
+  updateAngularArrowLocalProperties();
+}
+
+void TwistWithCovarianceStampedDisplay::lazyDeserializationPropertyCallback()
+{
+  resubscribe();
+}
+
+void TwistWithCovarianceStampedDisplay::updateTwistRendering()
+{
+  const auto & twist = pending_twist_;
+  const auto & ogre_position = pending_position_;
+  const auto & ogre_quaternion = pending_quaternion_;
+
+  converter::rvizArrowConverter(
+    *rviz_linear_arrow_,
+    twist.linear,
+    ogre_quaternion,
+    linear_arrow_properties_
+  );
+  rviz_linear_arrow_->setPosition(ogre_position);
+
+  const QColor linear_arrow_color = linear_color_property_->getColor();
+
+  rviz_linear_arrow_->setColor(
+    linear_arrow_color.redF(),
+    linear_arrow_color.greenF(),
+    linear_arrow_color.blueF(),
+    linear_color_alpha_property_->getFloat()
+  );
+
+  const bool is_linear_covariance_visible = linear_covariance_property_->getBool();
+  rviz_linear_covariance_->getRootNode()->setVisible(is_linear_covariance_visible);
+
+  if (is_linear_covariance_visible) {
+    converter::rvizCovarianceConverter(
+      *rviz_linear_covariance_,
+      twist.linear,
+      pending_linear_covariance_,
+      ogre_position,
+      ogre_quaternion,
+      linear_covariance_properties_
+    );
+
+    const QColor linear_covariance_color = linear_covariance_color_property_->getColor();
+
+    rviz_linear_covariance_->setColor(
+      linear_covariance_color.redF(),
+      linear_covariance_color.greenF(),
+      linear_covariance_color.blueF(),
+      linear_covariance_alpha_property_->getFloat()
+    );
+  }
+
+  converter::rvizArrowConverter(
+    *rviz_angular_arrow_,
+    twist.angular,
+    ogre_quaternion,
+    angular_arrow_properties_
+  );
+  rviz_angular_arrow_->setPosition(ogre_position);
+
+  const QColor angular_arrow_color = angular_color_property_->getColor();
+
+  rviz_angular_arrow_->setColor(
+    angular_arrow_color.redF(),
+    angular_arrow_color.greenF(),
+    angular_arrow_color.blueF(),
+    angular_color_alpha_property_->getFloat()
+  );
+
+  const bool is_angular_covariance_visible = angular_covariance_property_->getBool();
+  rviz_angular_covariance_->getRootNode()->setVisible(is_angular_covariance_visible);
+
+  if (is_angular_covariance_visible) {
+    converter::rvizCovarianceConverter(
+      *rviz_angular_covariance_,
+      twist.angular,
+      pending_angular_covariance_,
+      ogre_position,
+      ogre_quaternion,
+      angular_covariance_properties_
+    );
+
+    const QColor angular_covariance_color = angular_covariance_color_property_->getColor();
+
+    rviz_angular_covariance_->setColor(
+      angular_covariance_color.redF(),
+      angular_covariance_color.greenF(),
+      angular_covariance_color.blueF(),
+      angular_covariance_alpha_property_->getFloat()
+    );
+  }
+}
+
+void TwistWithCovarianceStampedDisplay::updateLinearArrowLocalProperties()
+{
+  linear_arrow_properties_.arrow_scale = linear_arrow_scale_property_->getFloat();
+  linear_arrow_properties_.head_scale = linear_head_scale_property_->getFloat();
+  linear_arrow_properties_.head_radius = linear_head_radius_property_->getFloat();
+  linear_arrow_properties_.shaft_radius = linear_shaft_radius_property_->getFloat();
+
+  linear_covariance_properties_.arrow_scale = linear_arrow_scale_property_->getFloat();
+  linear_covariance_properties_.deviation_scale = linear_covariance_scale_property_->getFloat();
+}
+
+void TwistWithCovarianceStampedDisplay::updateAngularArrowLocalProperties()
+{
+  angular_arrow_properties_.arrow_scale = angular_arrow_scale_property_->getFloat();
+  angular_arrow_properties_.head_scale = angular_head_scale_property_->getFloat();
+  angular_arrow_properties_.head_radius = angular_head_radius_property_->getFloat();
+  angular_arrow_properties_.shaft_radius = angular_shaft_radius_property_->getFloat();
+
+  angular_covariance_properties_.arrow_scale = angular_arrow_scale_property_->getFloat();
+  angular_covariance_properties_.deviation_scale = angular_covariance_scale_property_->getFloat();
+}
+
+void TwistWithCovarianceStampedDisplay::initializeRenderingObjects()
+{
+  rviz_linear_arrow_ = std::make_unique<rviz_rendering::Arrow>(
+    this->scene_manager_,
+    this->scene_node_
+  );
+  rviz_linear_arrow_->set(0, 0, 0, 0);
+
+  rviz_angular_arrow_ = std::make_unique<rviz_rendering::Arrow>(
+    this->scene_manager_,
+    this->scene_node_
+  );
+  rviz_angular_arrow_->set(0, 0, 0, 0);
+
+  rviz_linear_covariance_ = std::make_unique<rviz_rendering::Shape>(
+    rviz_rendering::Shape::Sphere,
+    this->scene_manager_,
+    this->scene_node_
+  );
+  rviz_angular_covariance_ = std::make_unique<rviz_rendering::Shape>(
+    rviz_rendering::Shape::Sphere,
+    this->scene_manager_,
+    this->scene_node_
+  );
+}
+
+// Displays built from a context get their scene node with the first rendering objects
+void TwistWithCovarianceStampedDisplay::ensureSceneNode()
+{
+  if (!this->scene_node_) {
+    this->scene_node_ = this->scene_manager_->getRootSceneNode()->createChildSceneNode();
+  }
+}
+
+void TwistWithCovarianceStampedDisplay::destroyRenderingObjects()
+{
+  rviz_linear_arrow_.reset();
+  rviz_angular_arrow_.reset();
+  rviz_linear_covariance_.reset();
+  rviz_angular_covariance_.reset();
+}
+}  // namespace geometry_rviz_plugins::displays
+
+PLUGINLIB_EXPORT_CLASS(
+  geometry_rviz_plugins::displays::TwistWithCovarianceStampedDisplay,
+  rviz_common::Display
+)
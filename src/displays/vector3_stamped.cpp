@@ -22,12 +22,17 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <memory>
-#include <chrono>
+#include <string>
 
 #include <rviz_common/msg_conversions.hpp>
+#include <rviz_common/view_controller.hpp>
+#include <rviz_common/view_manager.hpp>
 #include <pluginlib/class_list_macros.hpp>
 
+#include <geometry_rviz_plugins/serialization/partial_deserializer.hpp>
+
 
 namespace geometry_rviz_plugins::displays
 {
@@ -35,14 +40,19 @@ Vector3StampedDisplay::Vector3StampedDisplay()
 : default_color_alpha_(1.0),
   default_shaft_radius_(0.05),
   default_head_radius_(0.1),
-  default_head_scale_(0.2)
+  default_head_scale_(0.2),
+  unrendered_count_(0),
+  is_rendering_dirty_(false)
 {
+  const auto construct_start_time = statistics::DisplayStatistics::Clock::now();
+
   arrow_color_property_.reset(
     new rviz_common::properties::ColorProperty(
       "Color",
       QColor(200, 200, 200),
       "Color to draw the vector arrow.",
-      this
+      this,
+      SLOT(arrowPropertyCallback())
     )
   );
 
@@ -51,7 +61,8 @@ Vector3StampedDisplay::Vector3StampedDisplay()
       "Alpha",
       default_color_alpha_,
       "Vector transparency.",
-      this
+      this,
+      SLOT(arrowPropertyCallback())
     )
   );
   color_alpha_property_->setMin(0);
@@ -100,6 +111,177 @@ Vector3StampedDisplay::Vector3StampedDisplay()
       SLOT(arrowPropertyCallback())
     )
   );
+
+  history_length_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "History Length",
+      1,
+      "Number of vectors to keep and draw.",
+      this,
+      SLOT(historyPropertyCallback())
+    )
+  );
+  history_length_property_->setMin(1);
+  history_length_property_->setMax(100000);
+
+  filter_type_property_.reset(
+    new rviz_common::properties::EnumProperty(
+      "Filter",
+      "None",
+      "Temporal filter applied to the incoming vectors.",
+      this,
+      SLOT(filterPropertyCallback())
+    )
+  );
+  filter_type_property_->addOption("None", static_cast<int>(filter::FilterType::NONE));
+  filter_type_property_->addOption("Low Pass", static_cast<int>(filter::FilterType::LOW_PASS));
+  filter_type_property_->addOption(
+    "Moving Average",
+    static_cast<int>(filter::FilterType::MOVING_AVERAGE)
+  );
+  filter_type_property_->addOption("Median", static_cast<int>(filter::FilterType::MEDIAN));
+
+  filter_window_size_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Window Size",
+      10,
+      "Number of samples of the moving average and median windows.",
+      filter_type_property_.get(),
+      SLOT(filterPropertyCallback()),
+      this
+    )
+  );
+  filter_window_size_property_->setMin(1);
+  filter_window_size_property_->setMax(10000);
+
+  filter_smoothing_factor_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Smoothing Factor",
+      0.2,
+      "Weight of the newest sample in the low pass filter.",
+      filter_type_property_.get(),
+      SLOT(filterPropertyCallback()),
+      this
+    )
+  );
+  filter_smoothing_factor_property_->setMin(0.001);
+  filter_smoothing_factor_property_->setMax(1);
+
+  lazy_deserialization_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Lazy Deserialization",
+      false,
+      "Subscribe to the serialized message and decode only the header and vector.",
+      this,
+      SLOT(lazyDeserializationPropertyCallback())
+    )
+  );
+
+  frustum_culling_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Frustum Culling",
+      false,
+      "Skip converting arrows outside of the camera view.",
+      this,
+      SLOT(cullingPropertyCallback())
+    )
+  );
+  screen_thinning_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Screen Thinning",
+      false,
+      "Limit the number of arrows drawn per screen grid cell, newest first.",
+      this,
+      SLOT(cullingPropertyCallback())
+    )
+  );
+  thinning_cell_size_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Cell Size",
+      32,
+      "Screen grid cell size in pixels.",
+      screen_thinning_property_.get(),
+      SLOT(cullingPropertyCallback()),
+      this
+    )
+  );
+  thinning_cell_size_property_->setMin(1);
+
+  thinning_cell_count_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Max Arrows Per Cell",
+      1,
+      "Number of arrows drawn at most per screen grid cell.",
+      screen_thinning_property_.get(),
+      SLOT(cullingPropertyCallback()),
+      this
+    )
+  );
+  thinning_cell_count_property_->setMin(1);
+
+  magnitude_label_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Magnitude Label",
+      false,
+      "Draw the vector magnitude next to each arrow.",
+      this,
+      SLOT(magnitudeLabelPropertyCallback())
+    )
+  );
+  magnitude_label_precision_property_.reset(
+    new rviz_common::properties::IntProperty(
+      "Precision",
+      2,
+      "Number of decimal places of the magnitude.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+  magnitude_label_precision_property_->setMin(0);
+  magnitude_label_precision_property_->setMax(6);
+
+  magnitude_label_unit_property_.reset(
+    new rviz_common::properties::StringProperty(
+      "Unit",
+      "",
+      "Unit appended to the magnitude.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+  magnitude_label_height_property_.reset(
+    new rviz_common::properties::FloatProperty(
+      "Character Height",
+      0.1,
+      "Height of the magnitude label characters.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+  magnitude_label_height_property_->setMin(0);
+
+  magnitude_label_color_property_.reset(
+    new rviz_common::properties::ColorProperty(
+      "Color",
+      QColor(255, 255, 255),
+      "Color to draw the magnitude label.",
+      magnitude_label_property_.get(),
+      SLOT(magnitudeLabelPropertyCallback()),
+      this
+    )
+  );
+
+  initializeStatisticsProperties();
+
+  updateCullingLocalProperties();
+  updateFilterLocalProperties();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - construct_start_time
+  );
 }
 
 Vector3StampedDisplay::Vector3StampedDisplay(rviz_common::DisplayContext * context)
@@ -107,11 +289,8 @@ Vector3StampedDisplay::Vector3StampedDisplay(rviz_common::DisplayContext * conte
 {
   this->context_ = context;
   this->scene_manager_ = context->getSceneManager();
-  this->scene_node_ = this->scene_manager_->getRootSceneNode()->createChildSceneNode();
 
   updateArrowLocalProperties();
-
-  initializeRvizArrow();
 }
 
 Vector3StampedDisplay::~Vector3StampedDisplay()
@@ -125,51 +304,94 @@ void Vector3StampedDisplay::reset()
 
   updateArrowLocalProperties();
 
-  initializeRvizArrow();
+  history_.clear();
+  vector_filter_.reset();
+  unrendered_count_ = 0;
+  is_rendering_dirty_ = false;
+  display_statistics_.reset();
 
-  MFDClass::reset();
+  IMFDClass::reset();
+}
+
+void Vector3StampedDisplay::update(float wall_dt, float ros_dt)
+{
+  const auto update_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::update(wall_dt, ros_dt);
+
+  // Visibility depends on the view, so a moving camera requires a visibility pass
+  Ogre::Camera * camera = getCurrentCamera();
+  const bool is_view_changed =
+    camera && isCullingEnabled() && screen_space_culler_.updateCamera(*camera);
+
+  if (unrendered_count_ > 0 || is_rendering_dirty_ || is_view_changed) {
+    // Thinning ranks every arrow against the newer ones, so it visits every slot too.
+    // Only slots that are new, dirty or stale and now visible are converted.
+    const bool is_full_pass =
+      is_rendering_dirty_ || is_view_changed || culling_properties_.is_thinning_enabled;
+
+    updateArrowRendering(
+      is_full_pass ? history_.size() : unrendered_count_,
+      is_rendering_dirty_ ? history_.size() : unrendered_count_
+    );
+
+    if (unrendered_count_ > 0) {
+      display_statistics_.countRendered(update_start_time);
+    }
+    unrendered_count_ = 0;
+    is_rendering_dirty_ = false;
+  }
+
+  display_statistics_.addFrameTime(
+    statistics::DisplayStatistics::Clock::now() - update_start_time
+  );
+  reportStatistics();
 }
 
 void Vector3StampedDisplay::processMessage(geometry_msgs::msg::Vector3Stamped::ConstSharedPtr msg)
 {
-  const Ogre::Vector3 offset_vector = position_offset_property_->getVector();
+  processVector(msg->header, msg->vector);
+}
+
+void Vector3StampedDisplay::processVector(
+  const std_msgs::msg::Header & header,
+  const geometry_msgs::msg::Vector3 & vector
+)
+{
+  const auto receive_time = statistics::DisplayStatistics::Clock::now();
+  display_statistics_.countReceived(receive_time);
 
   Ogre::Vector3 position;
   Ogre::Quaternion quaternion;
 
   const bool is_transformable_frame = this->context_->getFrameManager()->getTransform(
-    msg->header,
+    header,
     position,
     quaternion
   );
 
   if (!is_transformable_frame) {
-    this->setMissingTransformToFixedFrame(msg->header.frame_id);
+    display_statistics_.countRejected();
+    this->setMissingTransformToFixedFrame(header.frame_id);
     return;
   }
   this->setTransformOk();
 
-  position.x += offset_vector.x;
-  position.y += offset_vector.y;
-  position.z += offset_vector.z;
-
-  converter::rvizArrowConverter(
-    *rviz_arrow_,
-    msg->vector,
-    quaternion,
-    convert_arrow_properties_
-  );
-  rviz_arrow_->setPosition(
-    position
+  history_.push(
+    header,
+    vector_filter_.filter(header.frame_id, vector),
+    position,
+    quaternion
   );
 
-  const QColor arrow_color = arrow_color_property_->getColor();
+  // Vectors pushed out of the history before being drawn are coalesced.
+  if (++unrendered_count_ > history_.size()) {
+    display_statistics_.countCoalesced();
+    unrendered_count_ = history_.size();
+  }
 
-  rviz_arrow_->setColor(
-    arrow_color.redF(),
-    arrow_color.greenF(),
-    arrow_color.blueF(),
-    color_alpha_property_->getFloat()
+  display_statistics_.addProcessingTime(
+    statistics::DisplayStatistics::Clock::now() - receive_time
   );
 
   this->context_->queueRender();
@@ -177,21 +399,122 @@ void Vector3StampedDisplay::processMessage(geometry_msgs::msg::Vector3Stamped::C
 
 void Vector3StampedDisplay::onInitialize()
 {
-  MFDClass::onInitialize();
+  const auto initialize_start_time = statistics::DisplayStatistics::Clock::now();
+
+  IMFDClass::onInitialize();
+
+  display_statistics_.addStartupTime(
+    statistics::DisplayStatistics::Clock::now() - initialize_start_time
+  );
+}
+
+// Rendering objects and retained vectors are created again by the first
+// message after the display is enabled, an idle display only holds its properties.
+void Vector3StampedDisplay::onDisable()
+{
+  IMFDClass::onDisable();
+
+  screen_space_culler_.release();
+}
+
+void Vector3StampedDisplay::processSerializedMessage(
+  const rclcpp::SerializedMessage & serialized_msg
+)
+{
+  const bool is_deserialized = serialization::deserializeVector3Stamped(
+    serialized_msg,
+    serialized_header_,
+    serialized_vector_
+  );
+
+  updateDecodeStatus(is_deserialized);
+
+  if (!is_deserialized) {
+    return;
+  }
+  processVector(serialized_header_, serialized_vector_);
+}
+
+bool Vector3StampedDisplay::isSerializedSubscription() const
+{
+  return lazy_deserialization_property_->getBool();
+}
+
+void Vector3StampedDisplay::fixedFrameChanged()
+{
+  if (tf_filter_) {
+    tf_filter_->setTargetFrame(fixed_frame_.toStdString());
+  }
+  // Retained vectors are kept in their source frame, so they are moved to
+  // the new fixed frame instead of being dropped by a reset.
+  history_.retransform(*this->context_->getFrameManager());
+  is_rendering_dirty_ = true;
+
+  this->context_->queueRender();
 }
 
 void Vector3StampedDisplay::arrowPropertyCallback()
 {
   updateArrowLocalProperties();
+
+  // Labels share the arrow transparency
+  if (magnitude_labels_) {
+    updateMagnitudeLabelProperties();
+  }
+
+  is_rendering_dirty_ = true;
 }
 
-void Vector3StampedDisplay::initializeRvizArrow()
+void Vector3StampedDisplay::lazyDeserializationPropertyCallback()
 {
-  rviz_arrow_ = std::make_unique<rviz_rendering::Arrow>(
-    this->scene_manager_,
-    this->scene_node_
-  );
-  rviz_arrow_->set(0, 0, 0, 0);
+  resubscribe();
+}
+
+void Vector3StampedDisplay::historyPropertyCallback()
+{
+  history_.setCapacity(history_length_property_->getInt());
+
+  if (unrendered_count_ > history_.size()) {
+    unrendered_count_ = history_.size();
+  }
+  is_rendering_dirty_ = true;
+}
+
+void Vector3StampedDisplay::filterPropertyCallback()
+{
+  updateFilterLocalProperties();
+}
+
+void Vector3StampedDisplay::magnitudeLabelPropertyCallback()
+{
+  if (magnitude_labels_) {
+    updateMagnitudeLabelProperties();
+  }
+  is_rendering_dirty_ = true;
+}
+
+void Vector3StampedDisplay::cullingPropertyCallback()
+{
+  updateCullingLocalProperties();
+
+  is_rendering_dirty_ = true;
+}
+
+void Vector3StampedDisplay::resizeRvizArrows(std::size_t size)
+{
+  while (rviz_arrows_.size() < size) {
+    rviz_arrows_.push_back(
+      std::make_unique<rviz_rendering::Arrow>(
+        this->scene_manager_,
+        this->scene_node_
+      )
+    );
+    rviz_arrows_.back()->set(0, 0, 0, 0);
+  }
+  if (rviz_arrows_.size() > size) {
+    rviz_arrows_.resize(size);
+  }
+  is_slot_converted_.resize(size, false);
 }
 
 void Vector3StampedDisplay::updateArrowLocalProperties()
@@ -202,9 +525,177 @@ void Vector3StampedDisplay::updateArrowLocalProperties()
   convert_arrow_properties_.shaft_radius = shaft_radius_property_->getFloat();
 }
 
+// Updates the visibility of the newest visited vectors and converts the visible
+// ones whose arrow is stale, the newest stale_count slots are invalidated first.
+void Vector3StampedDisplay::updateArrowRendering(
+  std::size_t visited_count,
+  std::size_t stale_count
+)
+{
+  ensureSceneNode();
+
+  resizeRvizArrows(history_.size());
+
+  if (!magnitude_label_property_->getBool()) {
+    magnitude_labels_.reset();
+  } else if (!magnitude_labels_) {
+    magnitude_labels_ = std::make_unique<rendering::MagnitudeLabelBatch>(
+      this->scene_manager_,
+      this->scene_node_
+    );
+    updateMagnitudeLabelProperties();
+  }
+  if (magnitude_labels_) {
+    magnitude_labels_->resize(history_.size());
+  }
+
+  const Ogre::Vector3 offset_vector = position_offset_property_->getVector();
+  const QColor arrow_color = arrow_color_property_->getColor();
+
+  Ogre::Camera * camera = getCurrentCamera();
+  const bool is_culling_enabled = camera && isCullingEnabled();
+
+  if (is_culling_enabled) {
+    screen_space_culler_.begin(*camera, culling_properties_);
+  }
+
+  for (std::size_t i = history_.size() - std::min(stale_count, history_.size());
+    i < history_.size(); ++i)
+  {
+    is_slot_converted_[history_.slotOf(i)] = false;
+  }
+  const std::size_t first_index = history_.size() - std::min(visited_count, history_.size());
+
+  // Newest first, so thinning keeps the latest vectors of a crowded cell
+  for (std::size_t i = history_.size(); i-- > first_index; ) {
+    const std::size_t slot = history_.slotOf(i);
+    const auto & retained_vector = history_[i];
+    auto & rviz_arrow = rviz_arrows_[slot];
+
+    bool is_visible = retained_vector.is_transformed;
+
+    if (is_visible && is_culling_enabled) {
+      is_visible = screen_space_culler_.accept(
+        converter::rvizArrowBoundingSphere(
+          retained_vector.state,
+          retained_vector.position + offset_vector,
+          retained_vector.orientation,
+          convert_arrow_properties_
+        )
+      );
+    }
+    rviz_arrow->getSceneNode()->setVisible(is_visible);
+
+    if (magnitude_labels_) {
+      magnitude_labels_->setLabelVisible(slot, is_visible);
+    }
+    if (!is_visible || is_slot_converted_[slot]) {
+      continue;
+    }
+    is_slot_converted_[slot] = true;
+
+    converter::rvizArrowConverter(
+      *rviz_arrow,
+      retained_vector.state,
+      retained_vector.orientation,
+      convert_arrow_properties_
+    );
+    rviz_arrow->setPosition(
+      retained_vector.position + offset_vector
+    );
+    rviz_arrow->setColor(
+      arrow_color.redF(),
+      arrow_color.greenF(),
+      arrow_color.blueF(),
+      color_alpha_property_->getFloat()
+    );
+
+    if (magnitude_labels_) {
+      converter::magnitudeLabelConverter(
+        *magnitude_labels_,
+        slot,
+        retained_vector.state,
+        retained_vector.position + offset_vector,
+        retained_vector.orientation,
+        convert_arrow_properties_
+      );
+    }
+  }
+}
+
+void Vector3StampedDisplay::updateMagnitudeLabelProperties()
+{
+  const QColor label_color = magnitude_label_color_property_->getColor();
+
+  magnitude_labels_->setFormat(
+    magnitude_label_precision_property_->getInt(),
+    magnitude_label_unit_property_->getStdString()
+  );
+  magnitude_labels_->setCharacterHeight(magnitude_label_height_property_->getFloat());
+  magnitude_labels_->setColor(
+    label_color.redF(),
+    label_color.greenF(),
+    label_color.blueF(),
+    color_alpha_property_->getFloat()
+  );
+}
+
+void Vector3StampedDisplay::updateCullingLocalProperties()
+{
+  culling_properties_.is_frustum_culling_enabled = frustum_culling_property_->getBool();
+  culling_properties_.is_thinning_enabled = screen_thinning_property_->getBool();
+  culling_properties_.cell_size = thinning_cell_size_property_->getFloat();
+  culling_properties_.max_count_per_cell = thinning_cell_count_property_->getInt();
+}
+
+// Changing the filter restarts it, retained states stay as they were filtered.
+void Vector3StampedDisplay::updateFilterLocalProperties()
+{
+  const filter::TemporalFilterProperties filter_properties{
+    static_cast<filter::FilterType>(filter_type_property_->getOptionInt()),
+    static_cast<std::size_t>(filter_window_size_property_->getInt()),
+    filter_smoothing_factor_property_->getFloat()
+  };
+  vector_filter_.setProperties(filter_properties);
+
+  filter_window_size_property_->setHidden(
+    filter_properties.type != filter::FilterType::MOVING_AVERAGE &&
+    filter_properties.type != filter::FilterType::MEDIAN
+  );
+  filter_smoothing_factor_property_->setHidden(
+    filter_properties.type != filter::FilterType::LOW_PASS
+  );
+}
+
+bool Vector3StampedDisplay::isCullingEnabled() const
+{
+  return culling_properties_.is_frustum_culling_enabled ||
+         culling_properties_.is_thinning_enabled;
+}
+
+Ogre::Camera * Vector3StampedDisplay::getCurrentCamera() const
+{
+  if (!this->context_ || !this->context_->getViewManager()) {
+    return nullptr;
+  }
+  const auto view_controller = this->context_->getViewManager()->getCurrent();
+
+  return view_controller ? view_controller->getCamera() : nullptr;
+}
+
+// Displays built from a context get their scene node with the first rendering objects
+void Vector3StampedDisplay::ensureSceneNode()
+{
+  if (!this->scene_node_) {
+    this->scene_node_ = this->scene_manager_->getRootSceneNode()->createChildSceneNode();
+  }
+}
+
 void Vector3StampedDisplay::destroyRenderingObjects()
 {
-  rviz_arrow_.reset();
+  rviz_arrows_.clear();
+  magnitude_labels_.reset();
+  is_slot_converted_.clear();
 }
 }  // namespace geometry_rviz_plugins::displays
 
@@ -0,0 +1,215 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/filter/temporal_filter.hpp>
+
+#include <cmath>
+
+#include <iterator>
+#include <numeric>
+
+
+namespace geometry_rviz_plugins::filter
+{
+ScalarFilter::ScalarFilter()
+: properties_{FilterType::NONE, 1, 1.0},
+  window_head_(0),
+  window_count_(0),
+  low_pass_value_(0),
+  window_sum_(0),
+  samples_since_summation_(0)
+{
+}
+
+void ScalarFilter::setProperties(const TemporalFilterProperties & properties)
+{
+  properties_ = properties;
+
+  if (properties_.window_size < 1) {
+    properties_.window_size = 1;
+  }
+  reset();
+}
+
+// Releases the window, it is allocated again by the first windowed sample
+void ScalarFilter::reset()
+{
+  window_ = std::vector<double>();
+  window_head_ = 0;
+  window_count_ = 0;
+
+  low_pass_value_ = 0;
+
+  window_sum_ = 0;
+  samples_since_summation_ = 0;
+
+  lower_half_.clear();
+  upper_half_.clear();
+}
+
+double ScalarFilter::filter(double sample)
+{
+  // A single NaN would poison the running sum and the median ordering
+  if (!std::isfinite(sample)) {
+    return sample;
+  }
+
+  switch (properties_.type) {
+    case FilterType::LOW_PASS:
+      return filterLowPass(sample);
+    case FilterType::MOVING_AVERAGE:
+      return filterMovingAverage(sample);
+    case FilterType::MEDIAN:
+      return filterMedian(sample);
+    case FilterType::NONE:
+    default:
+      return sample;
+  }
+}
+
+double ScalarFilter::filterLowPass(double sample)
+{
+  if (window_count_ == 0) {
+    low_pass_value_ = sample;
+    window_count_ = 1;
+  } else {
+    low_pass_value_ += properties_.smoothing_factor * (sample - low_pass_value_);
+  }
+  return low_pass_value_;
+}
+
+double ScalarFilter::filterMovingAverage(double sample)
+{
+  double evicted;
+
+  if (pushWindow(sample, evicted)) {
+    window_sum_ -= evicted;
+  }
+  window_sum_ += sample;
+
+  // Resumming once per window bounds the rounding drift at amortized O(1)
+  if (++samples_since_summation_ >= window_.size()) {
+    window_sum_ = std::accumulate(window_.begin(), window_.begin() + window_count_, 0.0);
+    samples_since_summation_ = 0;
+  }
+  return window_sum_ / static_cast<double>(window_count_);
+}
+
+double ScalarFilter::filterMedian(double sample)
+{
+  double evicted;
+
+  // Balancing after each step keeps the lower half populated, which the
+  // insertion relies on to pick the half.
+  if (pushWindow(sample, evicted)) {
+    eraseMedian(evicted);
+    balanceMedian();
+  }
+  insertMedian(sample);
+  balanceMedian();
+
+  if (lower_half_.size() > upper_half_.size()) {
+    return *lower_half_.rbegin();
+  }
+  return 0.5 * (*lower_half_.rbegin() + *upper_half_.begin());
+}
+
+bool ScalarFilter::pushWindow(double sample, double & evicted)
+{
+  if (window_.empty()) {
+    window_.assign(properties_.window_size, 0);
+  }
+  const bool is_full = window_count_ == window_.size();
+
+  if (is_full) {
+    evicted = window_[window_head_];
+  } else {
+    ++window_count_;
+  }
+  window_[window_head_] = sample;
+  window_head_ = (window_head_ + 1) % window_.size();
+
+  return is_full;
+}
+
+void ScalarFilter::insertMedian(double sample)
+{
+  if (lower_half_.empty() || sample <= *lower_half_.rbegin()) {
+    lower_half_.insert(sample);
+  } else {
+    upper_half_.insert(sample);
+  }
+}
+
+void ScalarFilter::eraseMedian(double sample)
+{
+  // Every upper sample is at least the lower maximum, so equal values may
+  // be taken from either half.
+  if (!lower_half_.empty() && sample <= *lower_half_.rbegin()) {
+    lower_half_.erase(lower_half_.find(sample));
+  } else {
+    upper_half_.erase(upper_half_.find(sample));
+  }
+}
+
+void ScalarFilter::balanceMedian()
+{
+  if (lower_half_.size() > upper_half_.size() + 1) {
+    const auto lower_max = std::prev(lower_half_.end());
+    upper_half_.insert(*lower_max);
+    lower_half_.erase(lower_max);
+  } else if (upper_half_.size() > lower_half_.size()) {
+    const auto upper_min = upper_half_.begin();
+    lower_half_.insert(*upper_min);
+    upper_half_.erase(upper_min);
+  }
+}
+
+void Vector3Filter::setProperties(const TemporalFilterProperties & properties)
+{
+  x_filter_.setProperties(properties);
+  y_filter_.setProperties(properties);
+  z_filter_.setProperties(properties);
+}
+
+void Vector3Filter::reset()
+{
+  x_filter_.reset();
+  y_filter_.reset();
+  z_filter_.reset();
+}
+
+geometry_msgs::msg::Vector3 Vector3Filter::filter(
+  const std::string & frame_id,
+  const geometry_msgs::msg::Vector3 & vector
+)
+{
+  // Components of different frames cannot be mixed in one window
+  if (frame_id != frame_id_) {
+    reset();
+    frame_id_ = frame_id;
+  }
+  geometry_msgs::msg::Vector3 filtered_vector;
+  filtered_vector.x = x_filter_.filter(vector.x);
+  filtered_vector.y = y_filter_.filter(vector.y);
+  filtered_vector.z = z_filter_.filter(vector.z);
+  return filtered_vector;
+}
+}  // namespace geometry_rviz_plugins::filter
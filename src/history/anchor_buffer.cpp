@@ -0,0 +1,130 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/history/anchor_buffer.hpp>
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <iterator>
+
+#include <rclcpp/time.hpp>
+
+
+namespace geometry_rviz_plugins::history
+{
+AnchorBuffer::AnchorBuffer(std::size_t capacity)
+: capacity_(capacity)
+{
+}
+
+std::size_t AnchorBuffer::setCapacity(std::size_t capacity)
+{
+  capacity_ = capacity;
+  return trim();
+}
+
+std::size_t AnchorBuffer::capacity() const
+{
+  return capacity_;
+}
+
+std::size_t AnchorBuffer::size() const
+{
+  return poses_.size();
+}
+
+void AnchorBuffer::clear()
+{
+  poses_.clear();
+}
+
+std::size_t AnchorBuffer::push(
+  const std_msgs::msg::Header & header,
+  const geometry_msgs::msg::Pose & pose
+)
+{
+  // Compared as integers, stamps of different clock types would throw as rclcpp::Time
+  const std::int64_t stamp_nanoseconds = rclcpp::Time(header.stamp).nanoseconds();
+
+  if (poses_.empty() || poses_.back().stamp_nanoseconds <= stamp_nanoseconds) {
+    poses_.push_back(AnchorPose{stamp_nanoseconds, header, pose});
+  } else {
+    const auto position = std::upper_bound(
+      poses_.begin(),
+      poses_.end(),
+      stamp_nanoseconds,
+      [](std::int64_t stamp, const AnchorPose & anchor) {
+        return stamp < anchor.stamp_nanoseconds;
+      }
+    );
+    poses_.insert(position, AnchorPose{stamp_nanoseconds, header, pose});
+  }
+  return trim();
+}
+
+const AnchorPose * AnchorBuffer::findNearest(
+  std::int64_t stamp_nanoseconds,
+  std::int64_t tolerance_nanoseconds
+) const
+{
+  if (poses_.empty()) {
+    return nullptr;
+  }
+  const auto after = std::lower_bound(
+    poses_.begin(),
+    poses_.end(),
+    stamp_nanoseconds,
+    [](const AnchorPose & anchor, std::int64_t stamp) {
+      return anchor.stamp_nanoseconds < stamp;
+    }
+  );
+  const AnchorPose * nearest = nullptr;
+
+  if (after != poses_.end()) {
+    nearest = &*after;
+  }
+  if (after != poses_.begin()) {
+    const AnchorPose & before = *std::prev(after);
+
+    if (!nearest ||
+      stamp_nanoseconds - before.stamp_nanoseconds <
+      nearest->stamp_nanoseconds - stamp_nanoseconds)
+    {
+      nearest = &before;
+    }
+  }
+  if (std::abs(nearest->stamp_nanoseconds - stamp_nanoseconds) > tolerance_nanoseconds) {
+    return nullptr;
+  }
+  return nearest;
+}
+
+std::size_t AnchorBuffer::trim()
+{
+  std::size_t dropped_count = 0;
+
+  while (poses_.size() > capacity_) {
+    poses_.pop_front();
+    ++dropped_count;
+  }
+  return dropped_count;
+}
+}  // namespace geometry_rviz_plugins::history
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/math/symmetric_eigen3.hpp>
+
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+
+
+namespace geometry_rviz_plugins::math
+{
+namespace
+{
+Vector3d cross(const Vector3d & a, const Vector3d & b)
+{
+  return {
+    a[1] * b[2] - a[2] * b[1],
+    a[2] * b[0] - a[0] * b[2],
+    a[0] * b[1] - a[1] * b[0]
+  };
+}
+
+double dot(const Vector3d & a, const Vector3d & b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector3d scaled(const Vector3d & a, double scale)
+{
+  return {a[0] * scale, a[1] * scale, a[2] * scale};
+}
+
+Vector3d anyOrthogonal(const Vector3d & a)
+{
+  // Cross with the axis least aligned to the input for a well conditioned result
+  const Vector3d axis = std::abs(a[0]) < std::abs(a[1]) ?
+    (std::abs(a[0]) < std::abs(a[2]) ? Vector3d{1, 0, 0} : Vector3d{0, 0, 1}) :
+    (std::abs(a[1]) < std::abs(a[2]) ? Vector3d{0, 1, 0} : Vector3d{0, 0, 1});
+  const Vector3d orthogonal = cross(a, axis);
+  return scaled(orthogonal, 1.0 / std::sqrt(dot(orthogonal, orthogonal)));
+}
+
+/**
+ * Null space of (A - lambda I) from the largest cross product of its rows.
+ * Returns false when the eigenvalue is repeated and the null space is not a line.
+ */
+bool eigenvector(const Matrix3d & a, double eigenvalue, double tolerance, Vector3d & result)
+{
+  const Vector3d row0{a[0] - eigenvalue, a[1], a[2]};
+  const Vector3d row1{a[1], a[4] - eigenvalue, a[5]};
+  const Vector3d row2{a[2], a[5], a[8] - eigenvalue};
+
+  const std::array<Vector3d, 3> candidates{
+    cross(row0, row1),
+    cross(row0, row2),
+    cross(row1, row2)
+  };
+  double max_norm = 0;
+
+  for (const auto & candidate : candidates) {
+    const double norm = dot(candidate, candidate);
+
+    if (norm > max_norm) {
+      max_norm = norm;
+      result = candidate;
+    }
+  }
+  if (max_norm <= tolerance) {
+    return false;
+  }
+  result = scaled(result, 1.0 / std::sqrt(max_norm));
+  return true;
+}
+}  // namespace
+
+SymmetricEigen3 solveSymmetricEigen3(const Matrix3d & input)
+{
+  // Mirror the upper triangle so the lower one is never read
+  const Matrix3d a{
+    input[0], input[1], input[2],
+    input[1], input[4], input[5],
+    input[2], input[5], input[8]
+  };
+  SymmetricEigen3 result;
+
+  const double off_diagonal = a[1] * a[1] + a[2] * a[2] + a[5] * a[5];
+  const double mean = (a[0] + a[4] + a[8]) / 3;
+  const double diagonal_spread = (a[0] - mean) * (a[0] - mean) +
+    (a[4] - mean) * (a[4] - mean) +
+    (a[8] - mean) * (a[8] - mean);
+  const double spread = std::sqrt((diagonal_spread + 2 * off_diagonal) / 6);
+
+  if (spread <= 1e-12 * std::max(1.0, std::abs(mean))) {
+    result.eigenvalues = {mean, mean, mean};
+    result.eigenvectors = {Vector3d{1, 0, 0}, Vector3d{0, 1, 0}, Vector3d{0, 0, 1}};
+    return result;
+  }
+  // Trigonometric solution of the characteristic polynomial of
+  // B = (A - mean I) / spread, whose eigenvalues lie in [-2, 2].
+  const Matrix3d b{
+    (a[0] - mean) / spread, a[1] / spread, a[2] / spread,
+    a[1] / spread, (a[4] - mean) / spread, a[5] / spread,
+    a[2] / spread, a[5] / spread, (a[8] - mean) / spread
+  };
+  const double half_determinant = 0.5 * (
+    b[0] * (b[4] * b[8] - b[5] * b[7]) -
+    b[1] * (b[3] * b[8] - b[5] * b[6]) +
+    b[2] * (b[3] * b[7] - b[4] * b[6])
+  );
+  const double angle = std::acos(std::clamp(half_determinant, -1.0, 1.0)) / 3;
+
+  result.eigenvalues[0] = mean + 2 * spread * std::cos(angle);
+  result.eigenvalues[2] = mean + 2 * spread * std::cos(angle + 2 * M_PI / 3);
+  result.eigenvalues[1] = 3 * mean - result.eigenvalues[0] - result.eigenvalues[2];
+
+  // Start from the eigenvalue furthest from the others, it always has a
+  // one dimensional null space, then complete the basis.
+  const double tolerance = 1e-20 * std::pow(spread, 4);
+  auto & vectors = result.eigenvectors;
+
+  if (result.eigenvalues[0] - result.eigenvalues[1] >=
+    result.eigenvalues[1] - result.eigenvalues[2])
+  {
+    eigenvector(a, result.eigenvalues[0], tolerance, vectors[0]);
+
+    if (!eigenvector(a, result.eigenvalues[1], tolerance, vectors[1])) {
+      vectors[1] = anyOrthogonal(vectors[0]);
+    }
+    vectors[1] = cross(cross(vectors[0], vectors[1]), vectors[0]);
+    vectors[1] = scaled(vectors[1], 1.0 / std::sqrt(dot(vectors[1], vectors[1])));
+    vectors[2] = cross(vectors[0], vectors[1]);
+  } else {
+    eigenvector(a, result.eigenvalues[2], tolerance, vectors[2]);
+
+    if (!eigenvector(a, result.eigenvalues[1], tolerance, vectors[1])) {
+      vectors[1] = anyOrthogonal(vectors[2]);
+    }
+    vectors[1] = cross(vectors[2], cross(vectors[1], vectors[2]));
+    vectors[1] = scaled(vectors[1], 1.0 / std::sqrt(dot(vectors[1], vectors[1])));
+    vectors[0] = cross(vectors[1], vectors[2]);
+  }
+  return result;
+}
+}  // namespace geometry_rviz_plugins::math
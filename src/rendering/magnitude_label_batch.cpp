@@ -0,0 +1,427 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/rendering/magnitude_label_batch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include <string>
+
+#include <OgreFontManager.h>
+#include <OgreHardwarePixelBuffer.h>
+#include <OgreMaterialManager.h>
+#include <OgrePixelFormat.h>
+#include <OgreResourceGroupManager.h>
+#include <OgreTechnique.h>
+#include <OgreTextureManager.h>
+
+
+namespace geometry_rviz_plugins::rendering
+{
+namespace
+{
+// Cells hold a sign, digits, a point and a short unit
+constexpr std::size_t max_cell_characters = 16;
+constexpr std::size_t atlas_texture_width = 1024;
+constexpr std::size_t max_atlas_texture_height = 4096;
+constexpr std::size_t initial_atlas_row_count = 8;
+
+std::size_t toPixels(float texcoord, std::size_t size)
+{
+  return static_cast<std::size_t>(std::lround(texcoord * static_cast<float>(size)));
+}
+}  // namespace
+
+MagnitudeLabelBatch::MagnitudeLabelBatch(
+  Ogre::SceneManager * scene_manager,
+  Ogre::SceneNode * parent_node,
+  const std::string & font_name
+)
+: scene_manager_(scene_manager),
+  scene_node_(parent_node->createChildSceneNode()),
+  billboard_set_(nullptr),
+  atlas_generation_(0),
+  precision_(0),
+  quantization_scale_(1),
+  character_height_(0.1),
+  color_(Ogre::ColourValue::White)
+{
+  static int instance_count = 0;
+  name_ = "MagnitudeLabelBatch" + std::to_string(instance_count++);
+
+  font_ = Ogre::FontManager::getSingleton().getByName(
+    font_name,
+    Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME
+  );
+  font_->load();
+
+  // Glyphs are copied from a CPU image of the font texture into the cells
+  font_->getMaterial()->getTechnique(0)->getPass(0)->getTextureUnitState(0)
+  ->_getTexturePtr()->convertToImage(font_image_);
+
+  const Ogre::Font::UVRect & digit_texcoords = font_->getGlyphTexCoords('0');
+  const std::size_t digit_width = std::max<std::size_t>(
+    toPixels(digit_texcoords.right, font_image_.getWidth()) -
+    toPixels(digit_texcoords.left, font_image_.getWidth()),
+    1
+  );
+  cell_height_ = std::max<std::size_t>(
+    toPixels(digit_texcoords.bottom, font_image_.getHeight()) -
+    toPixels(digit_texcoords.top, font_image_.getHeight()),
+    1
+  );
+  cell_width_ = max_cell_characters * digit_width;
+  space_width_ = digit_width;
+
+  atlas_column_count_ = std::max<std::size_t>(atlas_texture_width / cell_width_, 1);
+  max_atlas_row_count_ = std::max<std::size_t>(max_atlas_texture_height / cell_height_, 1);
+  atlas_row_count_ = std::min(initial_atlas_row_count, max_atlas_row_count_);
+
+  blank_cell_.assign(
+    Ogre::PixelUtil::getMemorySize(cell_width_, cell_height_, 1, font_image_.getFormat()),
+    0
+  );
+  createAtlasTexture();
+
+  // The font material blends the glyph coverage, a clone samples the text
+  // atlas instead without affecting other users of the font.
+  material_ = font_->getMaterial()->clone(name_ + "Material");
+  material_->setDepthWriteEnabled(false);
+
+  Ogre::Pass * pass = material_->getTechnique(0)->getPass(0);
+  pass->setVertexColourTracking(Ogre::TVC_DIFFUSE);
+  pass->getTextureUnitState(0)->setTexture(atlas_texture_);
+
+  billboard_set_ = scene_manager_->createBillboardSet(name_);
+  billboard_set_->setMaterial(material_);
+  billboard_set_->setBillboardType(Ogre::BBT_POINT);
+  // Labels start at the anchor and extend up and to the right on screen
+  billboard_set_->setBillboardOrigin(Ogre::BBO_BOTTOM_LEFT);
+  billboard_set_->setAutoextend(true);
+  scene_node_->attachObject(billboard_set_);
+
+  setCharacterHeight(character_height_);
+}
+
+MagnitudeLabelBatch::~MagnitudeLabelBatch()
+{
+  scene_node_->detachAllObjects();
+  scene_manager_->destroyBillboardSet(billboard_set_);
+  scene_manager_->destroySceneNode(scene_node_);
+
+  Ogre::MaterialManager::getSingleton().remove(material_);
+  Ogre::TextureManager::getSingleton().remove(atlas_texture_);
+}
+
+void MagnitudeLabelBatch::setFormat(int precision, const std::string & unit)
+{
+  if (precision == precision_ && unit == unit_) {
+    return;
+  }
+  precision_ = precision;
+  quantization_scale_ = std::pow(10.0, precision);
+  unit_ = unit;
+
+  // Texts are formatted again by the next setLabel() of each label
+  for (auto & label : labels_) {
+    releaseCell(label.cell);
+    label.cell = no_cell_;
+    label.has_value = false;
+    updateLabelVisibility(label);
+  }
+}
+
+void MagnitudeLabelBatch::setCharacterHeight(float character_height)
+{
+  character_height_ = character_height;
+
+  billboard_set_->setDefaultDimensions(
+    character_height_ * static_cast<float>(cell_width_) / static_cast<float>(cell_height_),
+    character_height_
+  );
+}
+
+void MagnitudeLabelBatch::setColor(float r, float g, float b, float a)
+{
+  const Ogre::ColourValue color(r, g, b, a);
+
+  if (color == color_) {
+    return;
+  }
+  color_ = color;
+
+  for (auto & label : labels_) {
+    if (label.billboard) {
+      label.billboard->setColour(color_);
+    }
+  }
+}
+
+void MagnitudeLabelBatch::resize(std::size_t size)
+{
+  for (std::size_t index = size; index < labels_.size(); ++index) {
+    auto & label = labels_[index];
+
+    releaseCell(label.cell);
+
+    if (label.billboard) {
+      billboard_set_->removeBillboard(label.billboard);
+    }
+  }
+  labels_.resize(size, Label{false, true, false, 0, no_cell_, nullptr});
+}
+
+void MagnitudeLabelBatch::setLabel(
+  std::size_t index,
+  double value,
+  const Ogre::Vector3 & position
+)
+{
+  auto & label = labels_[index];
+
+  if (!label.billboard) {
+    label.billboard = billboard_set_->createBillboard(position, color_);
+    label.billboard->setDimensions(0, 0);
+    label.is_shown = false;
+  } else {
+    label.billboard->setPosition(position);
+  }
+  const auto quantized_value = std::llround(value * quantization_scale_);
+
+  if (!label.has_value || label.quantized_value != quantized_value) {
+    char text[64];
+
+    std::snprintf(
+      text,
+      sizeof(text),
+      unit_.empty() ? "%.*f" : "%.*f %s",
+      precision_,
+      value,
+      unit_.c_str()
+    );
+
+    // Acquired before the release, so a shared cell is not recycled in between
+    const std::size_t cell = acquireCell(text);
+    releaseCell(label.cell);
+
+    label.has_value = true;
+    label.quantized_value = quantized_value;
+    label.cell = cell;
+
+    if (cell != no_cell_) {
+      label.billboard->setTexcoordRect(cellTexcoords(cell));
+    }
+  }
+  updateLabelVisibility(label);
+}
+
+void MagnitudeLabelBatch::setLabelVisible(std::size_t index, bool is_visible)
+{
+  auto & label = labels_[index];
+
+  label.is_visible = is_visible;
+  updateLabelVisibility(label);
+}
+
+std::size_t MagnitudeLabelBatch::acquireCell(const std::string & text)
+{
+  const auto cached_cell = cell_of_text_.find(text);
+
+  if (cached_cell != cell_of_text_.end()) {
+    ++cells_[cached_cell->second].reference_count;
+    return cached_cell->second;
+  }
+  std::size_t cell = no_cell_;
+
+  // Unused cells keep their text for reuse until they are recycled here
+  while (!unused_cells_.empty()) {
+    const std::size_t unused_cell = unused_cells_.front();
+    unused_cells_.pop_front();
+    cells_[unused_cell].is_queued_unused = false;
+
+    if (cells_[unused_cell].reference_count == 0) {
+      cell = unused_cell;
+      cell_of_text_.erase(cells_[cell].text);
+      break;
+    }
+  }
+  if (cell == no_cell_) {
+    if (cells_.size() >= atlas_column_count_ * atlas_row_count_ && !growAtlas()) {
+      return no_cell_;
+    }
+    cells_.push_back(TextCell{"", 0, false});
+    cell = cells_.size() - 1;
+  }
+  cells_[cell].text = text;
+  cells_[cell].reference_count = 1;
+  cell_of_text_.emplace(text, cell);
+
+  renderCell(cell);
+  return cell;
+}
+
+void MagnitudeLabelBatch::releaseCell(std::size_t cell)
+{
+  if (cell == no_cell_) {
+    return;
+  }
+  auto & text_cell = cells_[cell];
+
+  if (--text_cell.reference_count == 0 && !text_cell.is_queued_unused) {
+    text_cell.is_queued_unused = true;
+    unused_cells_.push_back(cell);
+  }
+}
+
+bool MagnitudeLabelBatch::growAtlas()
+{
+  if (atlas_row_count_ >= max_atlas_row_count_) {
+    return false;
+  }
+  const Ogre::TexturePtr previous_texture = atlas_texture_;
+
+  atlas_row_count_ = std::min(2 * atlas_row_count_, max_atlas_row_count_);
+  createAtlasTexture();
+
+  material_->getTechnique(0)->getPass(0)->getTextureUnitState(0)->setTexture(atlas_texture_);
+  Ogre::TextureManager::getSingleton().remove(previous_texture);
+
+  for (std::size_t cell = 0; cell < cells_.size(); ++cell) {
+    renderCell(cell);
+  }
+  // Cells keep their place, only the vertical texcoords shrink
+  for (auto & label : labels_) {
+    if (label.billboard && label.cell != no_cell_) {
+      label.billboard->setTexcoordRect(cellTexcoords(label.cell));
+    }
+  }
+  return true;
+}
+
+void MagnitudeLabelBatch::createAtlasTexture()
+{
+  const std::size_t width = atlas_column_count_ * cell_width_;
+  const std::size_t height = atlas_row_count_ * cell_height_;
+
+  atlas_texture_ = Ogre::TextureManager::getSingleton().createManual(
+    name_ + "Atlas" + std::to_string(atlas_generation_++),
+    Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+    Ogre::TEX_TYPE_2D,
+    static_cast<Ogre::uint>(width),
+    static_cast<Ogre::uint>(height),
+    0,
+    font_image_.getFormat(),
+    Ogre::TU_STATIC_WRITE_ONLY
+  );
+
+  std::vector<std::uint8_t> blank_atlas(
+    Ogre::PixelUtil::getMemorySize(width, height, 1, font_image_.getFormat()),
+    0
+  );
+  atlas_texture_->getBuffer()->blitFromMemory(
+    Ogre::PixelBox(width, height, 1, font_image_.getFormat(), blank_atlas.data())
+  );
+}
+
+void MagnitudeLabelBatch::renderCell(std::size_t cell)
+{
+  const std::string & text = cells_[cell].text;
+
+  const std::size_t cell_x = (cell % atlas_column_count_) * cell_width_;
+  const std::size_t cell_y = (cell / atlas_column_count_) * cell_height_;
+
+  const Ogre::HardwarePixelBufferSharedPtr & buffer = atlas_texture_->getBuffer();
+
+  buffer->blitFromMemory(
+    Ogre::PixelBox(cell_width_, cell_height_, 1, font_image_.getFormat(), blank_cell_.data()),
+    Ogre::Box(cell_x, cell_y, cell_x + cell_width_, cell_y + cell_height_)
+  );
+  const Ogre::PixelBox font_pixels = font_image_.getPixelBox();
+  std::size_t cursor = 0;
+
+  for (const char character : text) {
+    if (character == ' ') {
+      cursor += space_width_;
+      continue;
+    }
+    const Ogre::Font::UVRect & texcoords =
+      font_->getGlyphTexCoords(static_cast<Ogre::Font::CodePoint>(character));
+
+    const std::size_t left = toPixels(texcoords.left, font_image_.getWidth());
+    const std::size_t right = toPixels(texcoords.right, font_image_.getWidth());
+    const std::size_t top = toPixels(texcoords.top, font_image_.getHeight());
+    const std::size_t bottom = std::min(
+      toPixels(texcoords.bottom, font_image_.getHeight()),
+      top + cell_height_
+    );
+
+    if (right <= left || bottom <= top) {
+      continue;
+    }
+    const std::size_t glyph_width = right - left;
+
+    // Texts longer than a cell are clipped
+    if (cursor + glyph_width > cell_width_) {
+      break;
+    }
+    buffer->blitFromMemory(
+      font_pixels.getSubVolume(Ogre::Box(left, top, right, bottom)),
+      Ogre::Box(cell_x + cursor, cell_y, cell_x + cursor + glyph_width, cell_y + bottom - top)
+    );
+    cursor += glyph_width;
+  }
+}
+
+Ogre::FloatRect MagnitudeLabelBatch::cellTexcoords(std::size_t cell) const
+{
+  const float atlas_width = static_cast<float>(atlas_column_count_ * cell_width_);
+  const float atlas_height = static_cast<float>(atlas_row_count_ * cell_height_);
+
+  const float cell_x = static_cast<float>((cell % atlas_column_count_) * cell_width_);
+  const float cell_y = static_cast<float>((cell / atlas_column_count_) * cell_height_);
+
+  return Ogre::FloatRect(
+    cell_x / atlas_width,
+    cell_y / atlas_height,
+    (cell_x + cell_width_) / atlas_width,
+    (cell_y + cell_height_) / atlas_height
+  );
+}
+
+// Hidden labels keep their billboard at zero size, so showing them again
+// does not touch the billboard pool.
+void MagnitudeLabelBatch::updateLabelVisibility(Label & label)
+{
+  const bool is_shown = label.billboard && label.is_visible && label.cell != no_cell_;
+
+  if (!label.billboard || label.is_shown == is_shown) {
+    return;
+  }
+  label.is_shown = is_shown;
+
+  if (is_shown) {
+    label.billboard->resetDimensions();
+  } else {
+    label.billboard->setDimensions(0, 0);
+  }
+}
+}  // namespace geometry_rviz_plugins::rendering
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/rendering/screen_space_culler.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+#include <OgreViewport.h>
+
+
+namespace geometry_rviz_plugins::rendering
+{
+ScreenSpaceCuller::ScreenSpaceCuller()
+: camera_(nullptr),
+  properties_{true, false, 1, 1},
+  view_matrix_(Ogre::Matrix4::IDENTITY),
+  view_projection_matrix_(Ogre::Matrix4::IDENTITY),
+  viewport_width_(0),
+  viewport_height_(0),
+  last_view_matrix_(Ogre::Matrix4::ZERO),
+  last_projection_matrix_(Ogre::Matrix4::ZERO)
+{
+}
+
+bool ScreenSpaceCuller::updateCamera(const Ogre::Camera & camera)
+{
+  const Ogre::Matrix4 & view_matrix = camera.getViewMatrix();
+  const Ogre::Matrix4 & projection_matrix = camera.getProjectionMatrix();
+
+  if (view_matrix == last_view_matrix_ && projection_matrix == last_projection_matrix_) {
+    return false;
+  }
+  last_view_matrix_ = view_matrix;
+  last_projection_matrix_ = projection_matrix;
+  return true;
+}
+
+void ScreenSpaceCuller::begin(
+  const Ogre::Camera & camera,
+  const ScreenSpaceCullingProperties & properties
+)
+{
+  camera_ = &camera;
+  properties_ = properties;
+
+  view_matrix_ = camera.getViewMatrix();
+  view_projection_matrix_ = camera.getProjectionMatrix() * view_matrix_;
+
+  const Ogre::Viewport * viewport = camera.getViewport();
+  viewport_width_ = viewport ? viewport->getActualWidth() : 0;
+  viewport_height_ = viewport ? viewport->getActualHeight() : 0;
+
+  // Keeps the buckets so steady state frames do not allocate
+  cell_counts_.clear();
+}
+
+bool ScreenSpaceCuller::accept(const Ogre::Sphere & bounding_sphere)
+{
+  if (properties_.is_frustum_culling_enabled && !camera_->isVisible(bounding_sphere)) {
+    return false;
+  }
+  if (!properties_.is_thinning_enabled || properties_.cell_size <= 0 || viewport_width_ <= 0) {
+    return true;
+  }
+  const Ogre::Vector3 & center = bounding_sphere.getCenter();
+
+  // Cameras look along -Z, objects behind the camera have no screen cell
+  if ((view_matrix_ * center).z >= 0) {
+    return true;
+  }
+  const Ogre::Vector3 device_position = view_projection_matrix_ * center;
+
+  const auto cell_x = static_cast<std::int64_t>(
+    std::floor((0.5f * device_position.x + 0.5f) * viewport_width_ / properties_.cell_size));
+  const auto cell_y = static_cast<std::int64_t>(
+    std::floor((0.5f - 0.5f * device_position.y) * viewport_height_ / properties_.cell_size));
+
+  const std::uint64_t cell_key =
+    (static_cast<std::uint64_t>(cell_x) << 32) ^ static_cast<std::uint32_t>(cell_y);
+  int & cell_count = cell_counts_[cell_key];
+
+  if (cell_count >= properties_.max_count_per_cell) {
+    return false;
+  }
+  ++cell_count;
+  return true;
+}
+
+void ScreenSpaceCuller::release()
+{
+  camera_ = nullptr;
+  last_view_matrix_ = Ogre::Matrix4::ZERO;
+  last_projection_matrix_ = Ogre::Matrix4::ZERO;
+
+  cell_counts_ = std::unordered_map<std::uint64_t, int>();
+}
+}  // namespace geometry_rviz_plugins::rendering
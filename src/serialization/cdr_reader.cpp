@@ -0,0 +1,144 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/serialization/cdr_reader.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+
+namespace geometry_rviz_plugins::serialization
+{
+namespace
+{
+bool isHostLittleEndian()
+{
+  const std::uint16_t value = 1;
+  std::uint8_t first_byte;
+  std::memcpy(&first_byte, &value, 1);
+  return first_byte == 1;
+}
+}  // namespace
+
+CdrReader::CdrReader(const std::uint8_t * buffer, std::size_t length)
+: buffer_(buffer),
+  length_(length),
+  offset_(encapsulation_size_),
+  is_swap_required_(false),
+  is_ok_(buffer != nullptr && length >= encapsulation_size_)
+{
+  if (!is_ok_) {
+    return;
+  }
+  // Only plain CDR_BE {0x00, 0x00} and CDR_LE {0x00, 0x01} are decoded,
+  // parameter lists and XCDR2 use a different layout and alignment.
+  if (buffer_[0] != 0x00 || (buffer_[1] != 0x00 && buffer_[1] != 0x01)) {
+    is_ok_ = false;
+    return;
+  }
+  const bool is_little_endian = buffer_[1] == 0x01;
+  is_swap_required_ = is_little_endian != isHostLittleEndian();
+}
+
+bool CdrReader::ok() const
+{
+  return is_ok_;
+}
+
+bool CdrReader::readInt32(std::int32_t & value)
+{
+  return align(sizeof(value)) && readBytes(&value, sizeof(value));
+}
+
+bool CdrReader::readUint32(std::uint32_t & value)
+{
+  return align(sizeof(value)) && readBytes(&value, sizeof(value));
+}
+
+bool CdrReader::readDouble(double & value)
+{
+  return align(sizeof(value)) && readBytes(&value, sizeof(value));
+}
+
+bool CdrReader::readString(std::string & value)
+{
+  std::uint32_t size;
+
+  if (!readUint32(size)) {
+    return false;
+  }
+  if (size > length_ - offset_) {
+    is_ok_ = false;
+    return false;
+  }
+  // The serialized size includes the terminating null character
+  const auto * characters = reinterpret_cast<const char *>(buffer_ + offset_);
+  value.assign(characters, size > 0 ? size - 1 : 0);
+  offset_ += size;
+  return true;
+}
+
+bool CdrReader::skipDoubles(std::size_t count)
+{
+  if (count == 0) {
+    return is_ok_;
+  }
+  if (!align(sizeof(double)) || count * sizeof(double) > length_ - offset_) {
+    is_ok_ = false;
+    return false;
+  }
+  offset_ += count * sizeof(double);
+  return true;
+}
+
+bool CdrReader::align(std::size_t size)
+{
+  if (!is_ok_) {
+    return false;
+  }
+  // Alignment is relative to the end of the encapsulation header
+  const std::size_t position = offset_ - encapsulation_size_;
+  const std::size_t padding = (size - position % size) % size;
+
+  if (padding > length_ - offset_) {
+    is_ok_ = false;
+    return false;
+  }
+  offset_ += padding;
+  return true;
+}
+
+bool CdrReader::readBytes(void * destination, std::size_t size)
+{
+  if (!is_ok_ || size > length_ - offset_) {
+    is_ok_ = false;
+    return false;
+  }
+  auto * bytes = static_cast<std::uint8_t *>(destination);
+  std::memcpy(bytes, buffer_ + offset_, size);
+
+  if (is_swap_required_) {
+    std::reverse(bytes, bytes + size);
+  }
+  offset_ += size;
+  return true;
+}
+}  // namespace geometry_rviz_plugins::serialization
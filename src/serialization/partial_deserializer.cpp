@@ -0,0 +1,111 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/serialization/partial_deserializer.hpp>
+
+#include <cstdint>
+
+#include <geometry_rviz_plugins/serialization/cdr_reader.hpp>
+
+
+namespace geometry_rviz_plugins::serialization
+{
+namespace
+{
+CdrReader makeReader(const rclcpp::SerializedMessage & serialized_msg)
+{
+  const auto & rcl_serialized_msg = serialized_msg.get_rcl_serialized_message();
+  return CdrReader(rcl_serialized_msg.buffer, rcl_serialized_msg.buffer_length);
+}
+
+bool readHeader(CdrReader & reader, std_msgs::msg::Header & header)
+{
+  return reader.readInt32(header.stamp.sec) &&
+         reader.readUint32(header.stamp.nanosec) &&
+         reader.readString(header.frame_id);
+}
+
+bool readVector3(CdrReader & reader, geometry_msgs::msg::Vector3 & vector)
+{
+  return reader.readDouble(vector.x) &&
+         reader.readDouble(vector.y) &&
+         reader.readDouble(vector.z);
+}
+
+//! Read the next three rows of a 6x6 matrix, keeping the columns from the offset
+bool readCovarianceBlock(CdrReader & reader, math::Matrix3d & block, int offset)
+{
+  for (int row = 0; row < 3; ++row) {
+    if (!reader.skipDoubles(offset) ||
+      !reader.readDouble(block[row * 3 + 0]) ||
+      !reader.readDouble(block[row * 3 + 1]) ||
+      !reader.readDouble(block[row * 3 + 2]) ||
+      !reader.skipDoubles(3 - offset))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool deserializeVector3Stamped(
+  const rclcpp::SerializedMessage & serialized_msg,
+  std_msgs::msg::Header & header,
+  geometry_msgs::msg::Vector3 & vector
+)
+{
+  CdrReader reader = makeReader(serialized_msg);
+
+  return readHeader(reader, header) &&
+         readVector3(reader, vector);
+}
+
+bool deserializeTwistStamped(
+  const rclcpp::SerializedMessage & serialized_msg,
+  std_msgs::msg::Header & header,
+  geometry_msgs::msg::Twist & twist
+)
+{
+  CdrReader reader = makeReader(serialized_msg);
+
+  return readHeader(reader, header) &&
+         readVector3(reader, twist.linear) &&
+         readVector3(reader, twist.angular);
+}
+
+bool deserializeTwistWithCovarianceStamped(
+  const rclcpp::SerializedMessage & serialized_msg,
+  std_msgs::msg::Header & header,
+  geometry_msgs::msg::Twist & twist,
+  math::Matrix3d & linear_covariance,
+  math::Matrix3d & angular_covariance
+)
+{
+  CdrReader reader = makeReader(serialized_msg);
+
+  // Row major 6x6 covariance, the cross terms between linear and angular are skipped
+  return readHeader(reader, header) &&
+         readVector3(reader, twist.linear) &&
+         readVector3(reader, twist.angular) &&
+         readCovarianceBlock(reader, linear_covariance, 0) &&
+         readCovarianceBlock(reader, angular_covariance, 3);
+}
+}  // namespace geometry_rviz_plugins::serialization
@@ -0,0 +1,259 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/statistics/display_statistics.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+
+namespace geometry_rviz_plugins::statistics
+{
+ExponentialMovingAverage::ExponentialMovingAverage(double smoothing_factor)
+: smoothing_factor_(smoothing_factor)
+{
+  reset();
+}
+
+void ExponentialMovingAverage::reset()
+{
+  has_value_ = false;
+  value_ = 0;
+}
+
+void ExponentialMovingAverage::add(double sample)
+{
+  if (!has_value_) {
+    has_value_ = true;
+    value_ = sample;
+    return;
+  }
+  value_ += smoothing_factor_ * (sample - value_);
+}
+
+double ExponentialMovingAverage::value() const
+{
+  return value_;
+}
+
+ExponentialMovingRate::ExponentialMovingRate(double smoothing_factor)
+: smoothing_factor_(smoothing_factor)
+{
+  reset();
+}
+
+void ExponentialMovingRate::reset()
+{
+  has_last_tick_ = false;
+  average_interval_ = 0;
+  last_tick_ = Clock::time_point();
+}
+
+void ExponentialMovingRate::tick(const Clock::time_point & now)
+{
+  if (!has_last_tick_) {
+    has_last_tick_ = true;
+    last_tick_ = now;
+    return;
+  }
+  const double interval = std::chrono::duration<double>(now - last_tick_).count();
+  last_tick_ = now;
+
+  if (average_interval_ <= 0) {
+    average_interval_ = interval;
+    return;
+  }
+  average_interval_ += smoothing_factor_ * (interval - average_interval_);
+}
+
+double ExponentialMovingRate::rate(const Clock::time_point & now) const
+{
+  if (!has_last_tick_ || average_interval_ <= 0) {
+    return 0;
+  }
+  // Decay the estimate while no events arrive so an idle stream reads as idle.
+  const double idle_interval = std::chrono::duration<double>(now - last_tick_).count();
+  return 1.0 / std::max(average_interval_, idle_interval);
+}
+
+DisplayStatistics::DisplayStatistics(double smoothing_factor)
+: received_(0),
+  rejected_(0),
+  coalesced_(0),
+  rendered_(0),
+  received_rate_(smoothing_factor),
+  rendered_rate_(smoothing_factor),
+  processing_time_(smoothing_factor),
+  frame_time_(smoothing_factor),
+  startup_time_(Clock::duration::zero()),
+  is_awaiting_first_message_(false),
+  has_first_message_(false),
+  first_message_time_(Clock::duration::zero())
+{
+}
+
+void DisplayStatistics::reset()
+{
+  received_ = 0;
+  rejected_ = 0;
+  coalesced_ = 0;
+  rendered_ = 0;
+  received_rate_.reset();
+  rendered_rate_.reset();
+  processing_time_.reset();
+  frame_time_.reset();
+}
+
+void DisplayStatistics::countReceived(const Clock::time_point & now)
+{
+  ++received_;
+  received_rate_.tick(now);
+
+  if (is_awaiting_first_message_) {
+    is_awaiting_first_message_ = false;
+    has_first_message_ = true;
+    first_message_time_ = now - enabled_time_;
+  }
+}
+
+void DisplayStatistics::countRejected()
+{
+  ++rejected_;
+}
+
+void DisplayStatistics::countCoalesced()
+{
+  ++coalesced_;
+}
+
+void DisplayStatistics::countRendered(const Clock::time_point & now)
+{
+  ++rendered_;
+  rendered_rate_.tick(now);
+}
+
+void DisplayStatistics::addProcessingTime(const Clock::duration & duration)
+{
+  processing_time_.add(std::chrono::duration<double>(duration).count());
+}
+
+void DisplayStatistics::addFrameTime(const Clock::duration & duration)
+{
+  frame_time_.add(std::chrono::duration<double>(duration).count());
+}
+
+void DisplayStatistics::addStartupTime(const Clock::duration & duration)
+{
+  startup_time_ += duration;
+}
+
+void DisplayStatistics::markEnabled(const Clock::time_point & now)
+{
+  enabled_time_ = now;
+  is_awaiting_first_message_ = true;
+  has_first_message_ = false;
+  first_message_time_ = Clock::duration::zero();
+}
+
+std::uint64_t DisplayStatistics::received() const
+{
+  return received_;
+}
+
+std::uint64_t DisplayStatistics::rejected() const
+{
+  return rejected_;
+}
+
+std::uint64_t DisplayStatistics::coalesced() const
+{
+  return coalesced_;
+}
+
+std::uint64_t DisplayStatistics::rendered() const
+{
+  return rendered_;
+}
+
+double DisplayStatistics::receivedRate(const Clock::time_point & now) const
+{
+  return received_rate_.rate(now);
+}
+
+double DisplayStatistics::renderedRate(const Clock::time_point & now) const
+{
+  return rendered_rate_.rate(now);
+}
+
+double DisplayStatistics::processingTime() const
+{
+  return processing_time_.value();
+}
+
+double DisplayStatistics::frameTime() const
+{
+  return frame_time_.value();
+}
+
+double DisplayStatistics::startupTime() const
+{
+  return std::chrono::duration<double>(startup_time_).count();
+}
+
+bool DisplayStatistics::hasFirstMessage() const
+{
+  return has_first_message_;
+}
+
+double DisplayStatistics::firstMessageTime() const
+{
+  return std::chrono::duration<double>(first_message_time_).count();
+}
+
+std::string DisplayStatistics::toString(const Clock::time_point & now) const
+{
+  char buffer[320];
+
+  const int length = std::snprintf(
+    buffer,
+    sizeof(buffer),
+    "%.1f Hz received, %.1f Hz rendered, %llu rejected, %llu coalesced, "
+    "%.1f us/msg, %.1f us/frame, %.1f ms startup",
+    receivedRate(now),
+    renderedRate(now),
+    static_cast<unsigned long long>(rejected()),  // NOLINT
+    static_cast<unsigned long long>(coalesced()),  // NOLINT
+    processingTime() * 1e6,
+    frameTime() * 1e6,
+    startupTime() * 1e3
+  );
+  if (hasFirstMessage() && length > 0 && static_cast<std::size_t>(length) < sizeof(buffer)) {
+    std::snprintf(
+      buffer + length,
+      sizeof(buffer) - length,
+      ", %.1f ms to first message",
+      firstMessageTime() * 1e3
+    );
+  }
+  return buffer;
+}
+}  // namespace geometry_rviz_plugins::statistics
@@ -0,0 +1,88 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/statistics/statistics_publisher.hpp>
+
+#include <string>
+
+
+namespace geometry_rviz_plugins::statistics
+{
+namespace
+{
+diagnostic_msgs::msg::KeyValue makeKeyValue(const std::string & key, const std::string & value)
+{
+  diagnostic_msgs::msg::KeyValue key_value;
+  key_value.key = key;
+  key_value.value = value;
+  return key_value;
+}
+}  // namespace
+
+StatisticsPublisher::StatisticsPublisher(
+  rclcpp::Node::SharedPtr node,
+  const std::string & topic_name
+)
+: clock_(node->get_clock()),
+  publisher_(
+    node->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      topic_name,
+      rclcpp::QoS(10)
+  ))
+{
+}
+
+void StatisticsPublisher::publish(
+  const std::string & display_name,
+  const DisplayStatistics & display_statistics,
+  const DisplayStatistics::Clock::time_point & now
+)
+{
+  diagnostic_msgs::msg::DiagnosticArray diagnostic_array;
+  diagnostic_array.header.stamp = clock_->now();
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = display_name;
+  status.message = display_statistics.toString(now);
+  status.values = {
+    makeKeyValue("received", std::to_string(display_statistics.received())),
+    makeKeyValue("rejected", std::to_string(display_statistics.rejected())),
+    makeKeyValue("coalesced", std::to_string(display_statistics.coalesced())),
+    makeKeyValue("rendered", std::to_string(display_statistics.rendered())),
+    makeKeyValue("received_rate", std::to_string(display_statistics.receivedRate(now))),
+    makeKeyValue("rendered_rate", std::to_string(display_statistics.renderedRate(now))),
+    makeKeyValue("processing_time", std::to_string(display_statistics.processingTime())),
+    makeKeyValue("frame_time", std::to_string(display_statistics.frameTime())),
+    makeKeyValue("startup_time", std::to_string(display_statistics.startupTime()))
+  };
+  if (display_statistics.hasFirstMessage()) {
+    status.values.push_back(
+      makeKeyValue(
+        "first_message_time",
+        std::to_string(display_statistics.firstMessageTime())
+      )
+    );
+  }
+  diagnostic_array.status.push_back(status);
+
+  publisher_->publish(diagnostic_array);
+}
+}  // namespace geometry_rviz_plugins::statistics
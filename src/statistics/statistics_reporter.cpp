@@ -0,0 +1,125 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <geometry_rviz_plugins/statistics/statistics_reporter.hpp>
+
+#include <rclcpp/exceptions.hpp>
+
+#include <chrono>
+#include <memory>
+
+
+namespace geometry_rviz_plugins::statistics
+{
+StatisticsReporter::StatisticsReporter(
+  rviz_common::Display * display,
+  const DisplayStatistics & display_statistics
+)
+: display_(display),
+  display_statistics_(display_statistics)
+{
+  publish_statistics_property_.reset(
+    new rviz_common::properties::BoolProperty(
+      "Publish Statistics",
+      false,
+      "Publish message throughput and drop counters as diagnostics.",
+      display_,
+      SLOT(publisherPropertyCallback()),
+      this
+    )
+  );
+  statistics_topic_property_.reset(
+    new rviz_common::properties::StringProperty(
+      "Topic",
+      "/rviz/display_statistics",
+      "Topic to publish the display statistics.",
+      publish_statistics_property_.get(),
+      SLOT(publisherPropertyCallback()),
+      this
+    )
+  );
+}
+
+StatisticsReporter::~StatisticsReporter() = default;
+
+void StatisticsReporter::enable(
+  rviz_common::ros_integration::RosNodeAbstractionIface::WeakPtr ros_node
+)
+{
+  ros_node_ = ros_node;
+
+  publisherPropertyCallback();
+}
+
+void StatisticsReporter::disable()
+{
+  ros_node_.reset();
+  statistics_publisher_.reset();
+  display_->deleteStatusStd("Statistics Topic");
+}
+
+void StatisticsReporter::report()
+{
+  const auto now = DisplayStatistics::Clock::now();
+
+  if (now - last_report_time_ < std::chrono::seconds(1)) {
+    return;
+  }
+  last_report_time_ = now;
+
+  display_->setStatusStd(
+    rviz_common::properties::StatusProperty::Ok,
+    "Statistics",
+    display_statistics_.toString(now)
+  );
+
+  if (statistics_publisher_) {
+    statistics_publisher_->publish(
+      display_->getName().toStdString(),
+      display_statistics_,
+      now
+    );
+  }
+}
+
+void StatisticsReporter::publisherPropertyCallback()
+{
+  statistics_publisher_.reset();
+  display_->deleteStatusStd("Statistics Topic");
+
+  const auto ros_node = ros_node_.lock();
+
+  if (!ros_node || !publish_statistics_property_->getBool()) {
+    return;
+  }
+  try {
+    statistics_publisher_ = std::make_unique<StatisticsPublisher>(
+      ros_node->get_raw_node(),
+      statistics_topic_property_->getStdString()
+    );
+  } catch (const rclcpp::exceptions::InvalidTopicNameError & e) {
+    display_->setStatus(
+      rviz_common::properties::StatusProperty::Error,
+      "Statistics Topic",
+      QString("Error advertising: ") + e.what()
+    );
+  }
+}
+}  // namespace geometry_rviz_plugins::statistics
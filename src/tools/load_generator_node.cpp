@@ -0,0 +1,329 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cmath>
+#include <ctime>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include <tf2_ros/static_transform_broadcaster.h>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+
+namespace geometry_rviz_plugins::tools
+{
+// Deterministic per-axis sinusoid, sampled by sequence number so the emitted
+// values do not depend on scheduling jitter.
+struct AxisPattern
+{
+  double amplitude,
+    frequency,
+    phase;
+
+  double sample(std::uint64_t sequence, double rate) const
+  {
+    return amplitude * std::sin(2 * M_PI * frequency * sequence / rate + phase);
+  }
+};
+
+struct TopicPattern
+{
+  std::string frame_id;
+  AxisPattern axes[6];
+
+  geometry_msgs::msg::Vector3 vector(std::uint64_t sequence, double rate, int offset) const
+  {
+    geometry_msgs::msg::Vector3 vector;
+    vector.x = axes[offset + 0].sample(sequence, rate);
+    vector.y = axes[offset + 1].sample(sequence, rate);
+    vector.z = axes[offset + 2].sample(sequence, rate);
+    return vector;
+  }
+};
+
+class LoadGeneratorNode : public rclcpp::Node
+{
+public:
+  explicit LoadGeneratorNode(const rclcpp::NodeOptions & options)
+  : rclcpp::Node("load_generator", options),
+    published_count_(0),
+    is_running_(true)
+  {
+    const auto message_type = this->declare_parameter<std::string>(
+      "message_type", "twist_stamped");
+    rate_ = this->declare_parameter<double>("rate", 1000.0);
+    const auto topic_count = this->declare_parameter<int>("topic_count", 1);
+    const auto frame_count = this->declare_parameter<int>("frame_count", 1);
+    const auto topic_prefix = this->declare_parameter<std::string>(
+      "topic_prefix", "load_generator/topic");
+    const auto frame_prefix = this->declare_parameter<std::string>(
+      "frame_prefix", "load_generator/frame");
+    const auto parent_frame = this->declare_parameter<std::string>("parent_frame", "map");
+    const auto frame_spacing = this->declare_parameter<double>("frame_spacing", 1.0);
+    const auto seed = this->declare_parameter<int>("seed", 0);
+    const auto report_period = this->declare_parameter<double>("report_period", 1.0);
+    const auto statistics_topic = this->declare_parameter<std::string>(
+      "statistics_topic", "/rviz/display_statistics");
+    const auto reliability = this->declare_parameter<std::string>("reliability", "reliable");
+
+    if (rate_ <= 0 || report_period <= 0 || topic_count < 1 || frame_count < 1) {
+      throw std::invalid_argument(
+        "rate, report_period, topic_count and frame_count must be positive");
+    }
+    if (reliability != "reliable" && reliability != "best_effort") {
+      throw std::invalid_argument("reliability must be reliable or best_effort");
+    }
+    if (message_type != "twist_stamped" && message_type != "vector3_stamped") {
+      throw std::invalid_argument("message_type must be twist_stamped or vector3_stamped");
+    }
+    is_twist_ = message_type == "twist_stamped";
+
+    // rviz subscribes reliably by default and would not match a best effort publisher
+    auto qos = rclcpp::QoS(rclcpp::KeepLast(10));
+    if (reliability == "best_effort") {
+      qos.best_effort();
+    } else {
+      qos.reliable();
+    }
+
+    std::mt19937 random_engine(seed);
+    std::uniform_real_distribution<double> amplitude_distribution(0.2, 2.0),
+      frequency_distribution(0.05, 2.0),
+      phase_distribution(0, 2 * M_PI);
+
+    for (int i = 0; i < topic_count; ++i) {
+      TopicPattern pattern;
+      pattern.frame_id = frame_prefix + std::to_string(i % frame_count);
+
+      for (auto & axis : pattern.axes) {
+        axis.amplitude = amplitude_distribution(random_engine);
+        axis.frequency = frequency_distribution(random_engine);
+        axis.phase = phase_distribution(random_engine);
+      }
+      topic_patterns_.push_back(pattern);
+
+      const auto topic_name = topic_prefix + std::to_string(i);
+
+      if (is_twist_) {
+        twist_publishers_.push_back(
+          this->create_publisher<geometry_msgs::msg::TwistStamped>(
+            topic_name, qos));
+      } else {
+        vector3_publishers_.push_back(
+          this->create_publisher<geometry_msgs::msg::Vector3Stamped>(
+            topic_name, qos));
+      }
+    }
+
+    static_transform_broadcaster_ = std::make_unique<tf2_ros::StaticTransformBroadcaster>(*this);
+    std::vector<geometry_msgs::msg::TransformStamped> transforms;
+    const int grid_width = static_cast<int>(std::ceil(std::sqrt(frame_count)));
+
+    for (int i = 0; i < frame_count; ++i) {
+      geometry_msgs::msg::TransformStamped transform;
+      transform.header.stamp = this->now();
+      transform.header.frame_id = parent_frame;
+      transform.child_frame_id = frame_prefix + std::to_string(i);
+      transform.transform.translation.x = frame_spacing * (i % grid_width);
+      transform.transform.translation.y = frame_spacing * (i / grid_width);
+      transform.transform.rotation.w = 1;
+      transforms.push_back(transform);
+    }
+    static_transform_broadcaster_->sendTransform(transforms);
+
+    statistics_subscription_ = this->create_subscription<diagnostic_msgs::msg::DiagnosticArray>(
+      statistics_topic,
+      rclcpp::QoS(10),
+      [this](diagnostic_msgs::msg::DiagnosticArray::ConstSharedPtr msg) {
+        std::lock_guard<std::mutex> lock(display_statuses_mutex_);
+        for (const auto & status : msg->status) {
+          display_statuses_[status.name] = status;
+        }
+      }
+    );
+
+    last_report_time_ = std::chrono::steady_clock::now();
+    last_report_cpu_time_ = processCpuTime();
+    last_report_published_count_ = 0;
+
+    report_timer_ = this->create_wall_timer(
+      std::chrono::duration<double>(report_period),
+      [this]() {report();}
+    );
+
+    RCLCPP_INFO(
+      this->get_logger(),
+      "Publishing %s on %d topics across %d frames at %.1f Hz each",
+      message_type.c_str(), topic_count, frame_count, rate_);
+
+    publish_thread_ = std::thread([this]() {publishLoop();});
+  }
+
+  ~LoadGeneratorNode() override
+  {
+    is_running_ = false;
+
+    if (publish_thread_.joinable()) {
+      publish_thread_.join();
+    }
+  }
+
+private:
+  double rate_;
+  bool is_twist_;
+
+  std::vector<TopicPattern> topic_patterns_;
+  std::vector<rclcpp::Publisher<geometry_msgs::msg::TwistStamped>::SharedPtr> twist_publishers_;
+  std::vector<rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>::SharedPtr>
+  vector3_publishers_;
+
+  std::unique_ptr<tf2_ros::StaticTransformBroadcaster> static_transform_broadcaster_;
+
+  rclcpp::Subscription<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr statistics_subscription_;
+  std::mutex display_statuses_mutex_;
+  std::map<std::string, diagnostic_msgs::msg::DiagnosticStatus> display_statuses_;
+
+  rclcpp::TimerBase::SharedPtr report_timer_;
+  std::chrono::steady_clock::time_point last_report_time_;
+  double last_report_cpu_time_;
+  std::uint64_t last_report_published_count_;
+
+  std::atomic<std::uint64_t> published_count_;
+  std::atomic<bool> is_running_;
+  std::thread publish_thread_;
+
+  static double processCpuTime()
+  {
+    timespec cpu_time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time);
+    return cpu_time.tv_sec + cpu_time.tv_nsec * 1e-9;
+  }
+
+  // Wall timers cannot fire at tens of kHz, so messages are published in
+  // batches catching up to the schedule implied by the requested rate.
+  void publishLoop()
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    const std::uint64_t max_batch_size = std::max<std::uint64_t>(1, rate_ / 100);
+    std::uint64_t sequence = 0;
+
+    while (is_running_ && rclcpp::ok()) {
+      const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+      const auto scheduled_sequence = static_cast<std::uint64_t>(elapsed * rate_);
+
+      if (sequence >= scheduled_sequence) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+      // Drop the backlog instead of bursting when the publisher falls behind.
+      if (scheduled_sequence - sequence > max_batch_size) {
+        sequence = scheduled_sequence - max_batch_size;
+      }
+      for (; sequence < scheduled_sequence; ++sequence) {
+        publishAll(sequence);
+      }
+    }
+  }
+
+  void publishAll(std::uint64_t sequence)
+  {
+    const auto stamp = this->now();
+
+    for (std::size_t i = 0; i < topic_patterns_.size(); ++i) {
+      const auto & pattern = topic_patterns_[i];
+
+      if (is_twist_) {
+        auto msg = std::make_unique<geometry_msgs::msg::TwistStamped>();
+        msg->header.stamp = stamp;
+        msg->header.frame_id = pattern.frame_id;
+        msg->twist.linear = pattern.vector(sequence, rate_, 0);
+        msg->twist.angular = pattern.vector(sequence, rate_, 3);
+        twist_publishers_[i]->publish(std::move(msg));
+      } else {
+        auto msg = std::make_unique<geometry_msgs::msg::Vector3Stamped>();
+        msg->header.stamp = stamp;
+        msg->header.frame_id = pattern.frame_id;
+        msg->vector = pattern.vector(sequence, rate_, 0);
+        vector3_publishers_[i]->publish(std::move(msg));
+      }
+      ++published_count_;
+    }
+  }
+
+  void report()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    const double cpu_time = processCpuTime();
+    const std::uint64_t published_count = published_count_;
+
+    const double elapsed = std::chrono::duration<double>(now - last_report_time_).count();
+    const auto published = published_count - last_report_published_count_;
+
+    if (elapsed > 0 && published > 0) {
+      RCLCPP_INFO(
+        this->get_logger(),
+        "Published %.1f msg/s, %.2f us CPU time per message",
+        published / elapsed,
+        1e6 * (cpu_time - last_report_cpu_time_) / published);
+    }
+    last_report_time_ = now;
+    last_report_cpu_time_ = cpu_time;
+    last_report_published_count_ = published_count;
+
+    std::lock_guard<std::mutex> lock(display_statuses_mutex_);
+    for (const auto & [name, status] : display_statuses_) {
+      RCLCPP_INFO(this->get_logger(), "Display %s: %s", name.c_str(), status.message.c_str());
+    }
+    display_statuses_.clear();
+  }
+};
+}  // namespace geometry_rviz_plugins::tools
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+
+  auto node = std::make_shared<geometry_rviz_plugins::tools::LoadGeneratorNode>(
+    rclcpp::NodeOptions()
+  );
+  rclcpp::spin(node);
+
+  node.reset();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <geometry_rviz_plugins/history/anchor_buffer.hpp>
+
+
+namespace
+{
+using geometry_rviz_plugins::history::AnchorBuffer;
+
+std_msgs::msg::Header makeHeader(std::int64_t stamp_nanoseconds)
+{
+  std_msgs::msg::Header header;
+  header.stamp.sec = static_cast<std::int32_t>(stamp_nanoseconds / 1000000000);
+  header.stamp.nanosec = static_cast<std::uint32_t>(stamp_nanoseconds % 1000000000);
+  header.frame_id = "map";
+  return header;
+}
+
+geometry_msgs::msg::Pose makePose(double x)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  return pose;
+}
+
+std::int64_t nearestStamp(
+  const AnchorBuffer & buffer,
+  std::int64_t stamp_nanoseconds,
+  std::int64_t tolerance_nanoseconds
+)
+{
+  const auto * nearest = buffer.findNearest(stamp_nanoseconds, tolerance_nanoseconds);
+  return nearest ? nearest->stamp_nanoseconds : -1;
+}
+}  // namespace
+
+TEST(AnchorBuffer, EmptyBufferHasNoNearest)
+{
+  AnchorBuffer buffer;
+
+  EXPECT_EQ(buffer.findNearest(0, 1000000000), nullptr);
+}
+
+TEST(AnchorBuffer, ToleranceIsInclusive)
+{
+  AnchorBuffer buffer;
+  buffer.push(makeHeader(2000000000), makePose(1));
+
+  EXPECT_EQ(nearestStamp(buffer, 2000000000, 0), 2000000000);
+  EXPECT_EQ(nearestStamp(buffer, 2000000100, 100), 2000000000);
+  EXPECT_EQ(nearestStamp(buffer, 1999999900, 100), 2000000000);
+  EXPECT_EQ(nearestStamp(buffer, 2000000101, 100), -1);
+  EXPECT_EQ(nearestStamp(buffer, 1999999899, 100), -1);
+}
+
+TEST(AnchorBuffer, FindsNearestOnEitherSide)
+{
+  AnchorBuffer buffer;
+  buffer.push(makeHeader(1000), makePose(1));
+  buffer.push(makeHeader(2000), makePose(2));
+  buffer.push(makeHeader(3000), makePose(3));
+
+  EXPECT_EQ(nearestStamp(buffer, 0, 5000), 1000);
+  EXPECT_EQ(nearestStamp(buffer, 1400, 5000), 1000);
+  EXPECT_EQ(nearestStamp(buffer, 1600, 5000), 2000);
+  EXPECT_EQ(nearestStamp(buffer, 2999, 5000), 3000);
+  EXPECT_EQ(nearestStamp(buffer, 9000, 6000), 3000);
+  EXPECT_EQ(nearestStamp(buffer, 9000, 5000), -1);
+
+  EXPECT_EQ(buffer.findNearest(2100, 5000)->pose.position.x, 2);
+}
+
+TEST(AnchorBuffer, InsertsOutOfOrderPosesByStamp)
+{
+  AnchorBuffer buffer;
+  buffer.push(makeHeader(3000), makePose(3));
+  buffer.push(makeHeader(1000), makePose(1));
+  buffer.push(makeHeader(2000), makePose(2));
+
+  ASSERT_EQ(buffer.size(), 3u);
+  EXPECT_EQ(nearestStamp(buffer, 1100, 200), 1000);
+  EXPECT_EQ(nearestStamp(buffer, 1900, 200), 2000);
+  EXPECT_EQ(nearestStamp(buffer, 2900, 200), 3000);
+  EXPECT_EQ(buffer.findNearest(1000, 0)->pose.position.x, 1);
+}
+
+TEST(AnchorBuffer, DropsOldestStampsBeyondCapacity)
+{
+  AnchorBuffer buffer(2);
+
+  EXPECT_EQ(buffer.push(makeHeader(3000), makePose(3)), 0u);
+  EXPECT_EQ(buffer.push(makeHeader(1000), makePose(1)), 0u);
+  EXPECT_EQ(buffer.push(makeHeader(2000), makePose(2)), 1u);
+
+  ASSERT_EQ(buffer.size(), 2u);
+  EXPECT_EQ(nearestStamp(buffer, 1000, 500), -1);
+  EXPECT_EQ(nearestStamp(buffer, 2000, 0), 2000);
+
+  EXPECT_EQ(buffer.setCapacity(1), 1u);
+  EXPECT_EQ(nearestStamp(buffer, 2000, 0), -1);
+  EXPECT_EQ(nearestStamp(buffer, 3000, 0), 3000);
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include <geometry_rviz_plugins/statistics/display_statistics.hpp>
+
+
+namespace
+{
+using geometry_rviz_plugins::statistics::DisplayStatistics;
+using geometry_rviz_plugins::statistics::ExponentialMovingAverage;
+using geometry_rviz_plugins::statistics::ExponentialMovingRate;
+
+const ExponentialMovingRate::Clock::time_point kStart(std::chrono::seconds(100));
+
+ExponentialMovingRate::Clock::time_point at(double seconds)
+{
+  return kStart + std::chrono::duration_cast<ExponentialMovingRate::Clock::duration>(
+    std::chrono::duration<double>(seconds));
+}
+}  // namespace
+
+TEST(ExponentialMovingAverage, StartsAtTheFirstSample)
+{
+  ExponentialMovingAverage average(0.5);
+
+  EXPECT_DOUBLE_EQ(average.value(), 0);
+  average.add(4);
+  EXPECT_DOUBLE_EQ(average.value(), 4);
+  average.add(8);
+  EXPECT_DOUBLE_EQ(average.value(), 6);
+
+  average.reset();
+  average.add(2);
+  EXPECT_DOUBLE_EQ(average.value(), 2);
+}
+
+TEST(ExponentialMovingRate, NeedsTwoTicks)
+{
+  ExponentialMovingRate rate(0.1);
+
+  EXPECT_DOUBLE_EQ(rate.rate(at(0)), 0);
+  rate.tick(at(0));
+  EXPECT_DOUBLE_EQ(rate.rate(at(0)), 0);
+  rate.tick(at(0.1));
+  EXPECT_NEAR(rate.rate(at(0.1)), 10, 1e-6);
+}
+
+TEST(ExponentialMovingRate, TracksSteadyTicks)
+{
+  ExponentialMovingRate rate(0.1);
+
+  for (int i = 0; i <= 100; ++i) {
+    rate.tick(at(i * 0.01));
+  }
+  EXPECT_NEAR(rate.rate(at(1.0)), 100, 1e-3);
+}
+
+TEST(ExponentialMovingRate, DecaysWhileIdle)
+{
+  ExponentialMovingRate rate(0.1);
+
+  for (int i = 0; i <= 10; ++i) {
+    rate.tick(at(i * 0.1));
+  }
+  // Within the average interval the estimate holds
+  EXPECT_NEAR(rate.rate(at(1.05)), 10, 1e-6);
+  // Past it the estimate falls with the time since the last tick
+  EXPECT_NEAR(rate.rate(at(1.5)), 2, 1e-6);
+  EXPECT_NEAR(rate.rate(at(11.0)), 0.1, 1e-6);
+
+  rate.reset();
+  EXPECT_DOUBLE_EQ(rate.rate(at(11.0)), 0);
+}
+
+TEST(DisplayStatistics, CountsMessages)
+{
+  DisplayStatistics statistics;
+
+  statistics.countReceived(at(0));
+  statistics.countReceived(at(0.5));
+  statistics.countRejected();
+  statistics.countCoalesced();
+  statistics.countCoalesced();
+  statistics.countRendered(at(0.5));
+
+  EXPECT_EQ(statistics.received(), 2u);
+  EXPECT_EQ(statistics.rejected(), 1u);
+  EXPECT_EQ(statistics.coalesced(), 2u);
+  EXPECT_EQ(statistics.rendered(), 1u);
+  EXPECT_NEAR(statistics.receivedRate(at(0.5)), 2, 1e-6);
+  EXPECT_DOUBLE_EQ(statistics.renderedRate(at(0.5)), 0);
+}
+
+TEST(DisplayStatistics, ResetKeepsStartupAndFirstMessage)
+{
+  DisplayStatistics statistics;
+
+  statistics.addStartupTime(std::chrono::milliseconds(20));
+  statistics.addStartupTime(std::chrono::milliseconds(5));
+  statistics.markEnabled(at(0));
+  statistics.countReceived(at(0.25));
+  statistics.countReceived(at(0.5));
+  statistics.addProcessingTime(std::chrono::microseconds(10));
+  statistics.reset();
+
+  EXPECT_EQ(statistics.received(), 0u);
+  EXPECT_DOUBLE_EQ(statistics.receivedRate(at(0.5)), 0);
+  EXPECT_DOUBLE_EQ(statistics.processingTime(), 0);
+  EXPECT_NEAR(statistics.startupTime(), 0.025, 1e-9);
+  EXPECT_TRUE(statistics.hasFirstMessage());
+  EXPECT_NEAR(statistics.firstMessageTime(), 0.25, 1e-9);
+}
+
+TEST(DisplayStatistics, FirstMessageIsTimedFromEnabling)
+{
+  DisplayStatistics statistics;
+
+  statistics.countReceived(at(0));
+  EXPECT_FALSE(statistics.hasFirstMessage());
+
+  statistics.markEnabled(at(1));
+  EXPECT_FALSE(statistics.hasFirstMessage());
+  EXPECT_EQ(statistics.toString(at(1)).find("first message"), std::string::npos);
+
+  statistics.countReceived(at(1.5));
+  EXPECT_TRUE(statistics.hasFirstMessage());
+  EXPECT_NEAR(statistics.firstMessageTime(), 0.5, 1e-9);
+  EXPECT_NE(statistics.toString(at(1.5)).find("500.0 ms to first message"), std::string::npos);
+
+  statistics.markEnabled(at(2));
+  EXPECT_FALSE(statistics.hasFirstMessage());
+}
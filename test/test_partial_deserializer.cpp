@@ -0,0 +1,289 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <geometry_msgs/msg/twist_with_covariance_stamped.hpp>
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+
+#include <geometry_rviz_plugins/serialization/cdr_reader.hpp>
+#include <geometry_rviz_plugins/serialization/partial_deserializer.hpp>
+
+
+namespace
+{
+using geometry_rviz_plugins::serialization::CdrReader;
+
+template<typename MessageType>
+rclcpp::SerializedMessage serialize(const MessageType & msg)
+{
+  rclcpp::Serialization<MessageType> serialization;
+  rclcpp::SerializedMessage serialized_msg;
+
+  serialization.serialize_message(&msg, &serialized_msg);
+  return serialized_msg;
+}
+
+// Each length leaves a different padding in front of the first double
+const std::vector<std::string> frame_ids = {
+  "", "a", "ab", "map", "odom", "base_link", "base_footprint"
+};
+
+void appendUint32(std::vector<std::uint8_t> & buffer, std::uint32_t value)
+{
+  for (int byte = 0; byte < 4; ++byte) {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+  }
+}
+
+std::vector<std::uint8_t> littleEndianBuffer()
+{
+  return {0x00, 0x01, 0x00, 0x00};
+}
+}  // namespace
+
+TEST(CdrReader, ReadsLittleAndBigEndian)
+{
+  std::vector<std::uint8_t> little_endian = littleEndianBuffer();
+  appendUint32(little_endian, 0x01020304);
+
+  std::uint32_t value = 0;
+  CdrReader little_endian_reader(little_endian.data(), little_endian.size());
+
+  ASSERT_TRUE(little_endian_reader.readUint32(value));
+  EXPECT_EQ(value, 0x01020304u);
+
+  const std::vector<std::uint8_t> big_endian = {0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04};
+  CdrReader big_endian_reader(big_endian.data(), big_endian.size());
+
+  ASSERT_TRUE(big_endian_reader.readUint32(value));
+  EXPECT_EQ(value, 0x01020304u);
+}
+
+TEST(CdrReader, RejectsOtherEncapsulations)
+{
+  // PL_CDR_BE, PL_CDR_LE, CDR2_LE and a corrupted first byte
+  const std::vector<std::vector<std::uint8_t>> headers = {
+    {0x00, 0x02, 0x00, 0x00},
+    {0x00, 0x03, 0x00, 0x00},
+    {0x00, 0x07, 0x00, 0x00},
+    {0x01, 0x01, 0x00, 0x00}
+  };
+
+  for (auto buffer : headers) {
+    appendUint32(buffer, 1);
+    CdrReader reader(buffer.data(), buffer.size());
+
+    std::uint32_t value;
+    EXPECT_FALSE(reader.ok());
+    EXPECT_FALSE(reader.readUint32(value));
+  }
+}
+
+TEST(CdrReader, AlignsAfterOddLengthString)
+{
+  std::vector<std::uint8_t> buffer = littleEndianBuffer();
+  appendUint32(buffer, 2);
+  buffer.insert(buffer.end(), {'a', '\0'});
+  // Padding up to the 8 byte alignment of the double
+  buffer.insert(buffer.end(), 2, 0xff);
+
+  const double expected_value = 1.5;
+  const auto * expected_bytes = reinterpret_cast<const std::uint8_t *>(&expected_value);
+  const std::uint16_t endian_probe = 1;
+  const bool is_host_little_endian = *reinterpret_cast<const std::uint8_t *>(&endian_probe) == 1;
+
+  for (int byte = 0; byte < 8; ++byte) {
+    buffer.push_back(expected_bytes[is_host_little_endian ? byte : 7 - byte]);
+  }
+  CdrReader reader(buffer.data(), buffer.size());
+
+  std::string text;
+  double value = 0;
+
+  ASSERT_TRUE(reader.readString(text));
+  EXPECT_EQ(text, "a");
+  ASSERT_TRUE(reader.readDouble(value));
+  EXPECT_EQ(value, expected_value);
+}
+
+TEST(CdrReader, RejectsOversizedStringLength)
+{
+  std::vector<std::uint8_t> buffer = littleEndianBuffer();
+  appendUint32(buffer, 0xfffffff0);
+  buffer.insert(buffer.end(), {'a', 'b', 'c', '\0'});
+
+  CdrReader reader(buffer.data(), buffer.size());
+  std::string text;
+
+  EXPECT_FALSE(reader.readString(text));
+  EXPECT_FALSE(reader.ok());
+
+  // The reader stays failed
+  std::uint32_t value;
+  EXPECT_FALSE(reader.readUint32(value));
+}
+
+TEST(CdrReader, RejectsTruncatedBuffer)
+{
+  std::vector<std::uint8_t> buffer = littleEndianBuffer();
+  appendUint32(buffer, 1);
+
+  for (std::size_t length = 0; length < buffer.size(); ++length) {
+    CdrReader reader(buffer.data(), length);
+    std::uint32_t value;
+
+    EXPECT_FALSE(reader.readUint32(value)) << "length " << length;
+  }
+  EXPECT_FALSE(CdrReader(nullptr, 8).ok());
+}
+
+TEST(PartialDeserializer, Vector3StampedMatchesFullDeserialization)
+{
+  for (const auto & frame_id : frame_ids) {
+    geometry_msgs::msg::Vector3Stamped msg;
+    msg.header.stamp.sec = 12;
+    msg.header.stamp.nanosec = 345;
+    msg.header.frame_id = frame_id;
+    msg.vector.x = 1.25;
+    msg.vector.y = -2.5;
+    msg.vector.z = 3.75;
+
+    std_msgs::msg::Header header;
+    geometry_msgs::msg::Vector3 vector;
+
+    ASSERT_TRUE(
+      geometry_rviz_plugins::serialization::deserializeVector3Stamped(
+        serialize(msg),
+        header,
+        vector
+      )
+    ) << "frame_id \"" << frame_id << "\"";
+    EXPECT_EQ(header, msg.header);
+    EXPECT_EQ(vector, msg.vector);
+  }
+}
+
+TEST(PartialDeserializer, TwistStampedMatchesFullDeserialization)
+{
+  for (const auto & frame_id : frame_ids) {
+    geometry_msgs::msg::TwistStamped msg;
+    msg.header.stamp.sec = -1;
+    msg.header.stamp.nanosec = 999999999;
+    msg.header.frame_id = frame_id;
+    msg.twist.linear.x = 0.5;
+    msg.twist.linear.y = 1.5;
+    msg.twist.linear.z = 2.5;
+    msg.twist.angular.x = -0.5;
+    msg.twist.angular.y = -1.5;
+    msg.twist.angular.z = -2.5;
+
+    std_msgs::msg::Header header;
+    geometry_msgs::msg::Twist twist;
+
+    ASSERT_TRUE(
+      geometry_rviz_plugins::serialization::deserializeTwistStamped(
+        serialize(msg),
+        header,
+        twist
+      )
+    ) << "frame_id \"" << frame_id << "\"";
+    EXPECT_EQ(header, msg.header);
+    EXPECT_EQ(twist, msg.twist);
+  }
+}
+
+TEST(PartialDeserializer, TwistWithCovarianceStampedReadsDiagonalBlocks)
+{
+  for (const auto & frame_id : frame_ids) {
+    geometry_msgs::msg::TwistWithCovarianceStamped msg;
+    msg.header.frame_id = frame_id;
+    msg.twist.twist.linear.x = 1;
+    msg.twist.twist.angular.z = 2;
+
+    for (std::size_t i = 0; i < msg.twist.covariance.size(); ++i) {
+      msg.twist.covariance[i] = static_cast<double>(i);
+    }
+    std_msgs::msg::Header header;
+    geometry_msgs::msg::Twist twist;
+    geometry_rviz_plugins::math::Matrix3d linear_covariance, angular_covariance;
+
+    ASSERT_TRUE(
+      geometry_rviz_plugins::serialization::deserializeTwistWithCovarianceStamped(
+        serialize(msg),
+        header,
+        twist,
+        linear_covariance,
+        angular_covariance
+      )
+    ) << "frame_id \"" << frame_id << "\"";
+    EXPECT_EQ(header, msg.header);
+    EXPECT_EQ(twist, msg.twist.twist);
+
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t column = 0; column < 3; ++column) {
+        EXPECT_EQ(linear_covariance[row * 3 + column], msg.twist.covariance[row * 6 + column]);
+        EXPECT_EQ(
+          angular_covariance[row * 3 + column],
+          msg.twist.covariance[(row + 3) * 6 + column + 3]
+        );
+      }
+    }
+  }
+}
+
+TEST(PartialDeserializer, RejectsTruncatedMessages)
+{
+  geometry_msgs::msg::TwistWithCovarianceStamped msg;
+  msg.header.frame_id = "base_link";
+
+  rclcpp::SerializedMessage serialized_msg = serialize(msg);
+  auto & rcl_serialized_msg = serialized_msg.get_rcl_serialized_message();
+  const std::size_t full_length = rcl_serialized_msg.buffer_length;
+
+  std_msgs::msg::Header header;
+  geometry_msgs::msg::Twist twist;
+  geometry_rviz_plugins::math::Matrix3d linear_covariance, angular_covariance;
+
+  for (std::size_t length = 0; length < full_length; ++length) {
+    rcl_serialized_msg.buffer_length = length;
+
+    EXPECT_FALSE(
+      geometry_rviz_plugins::serialization::deserializeTwistWithCovarianceStamped(
+        serialized_msg,
+        header,
+        twist,
+        linear_covariance,
+        angular_covariance
+      )
+    ) << "length " << length;
+  }
+  rcl_serialized_msg.buffer_length = full_length;
+}
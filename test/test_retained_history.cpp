@@ -0,0 +1,152 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <geometry_rviz_plugins/history/retained_history.hpp>
+
+
+namespace
+{
+using History = geometry_rviz_plugins::history::RetainedHistory<int>;
+
+std::size_t pushState(History & history, int state)
+{
+  return history.push(std_msgs::msg::Header(), state, Ogre::Vector3(), Ogre::Quaternion());
+}
+
+std::vector<int> states(const History & history)
+{
+  std::vector<int> result;
+
+  for (std::size_t index = 0; index < history.size(); ++index) {
+    result.push_back(history[index].state);
+  }
+  return result;
+}
+
+std::vector<std::size_t> slots(const History & history)
+{
+  std::vector<std::size_t> result;
+
+  for (std::size_t index = 0; index < history.size(); ++index) {
+    result.push_back(history.slotOf(index));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(RetainedHistory, CapacityIsAtLeastOne)
+{
+  History history(0);
+
+  EXPECT_EQ(history.capacity(), 1u);
+  EXPECT_EQ(history.setCapacity(0), 0u);
+  EXPECT_EQ(history.capacity(), 1u);
+}
+
+TEST(RetainedHistory, FillsSlotsInOrder)
+{
+  History history(3);
+
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(pushState(history, 0), 0u);
+  EXPECT_EQ(pushState(history, 1), 1u);
+  EXPECT_EQ(pushState(history, 2), 2u);
+
+  EXPECT_EQ(states(history), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{0, 1, 2}));
+  EXPECT_EQ(history.back().state, 2);
+}
+
+TEST(RetainedHistory, OverwritesTheOldestSlotWhenFull)
+{
+  History history(3);
+
+  for (int state = 0; state < 3; ++state) {
+    pushState(history, state);
+  }
+  EXPECT_EQ(pushState(history, 3), 0u);
+  EXPECT_EQ(pushState(history, 4), 1u);
+
+  EXPECT_EQ(history.size(), 3u);
+  EXPECT_EQ(states(history), (std::vector<int>{2, 3, 4}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{2, 0, 1}));
+  EXPECT_EQ(history.back().state, 4);
+
+  EXPECT_EQ(pushState(history, 5), 2u);
+  EXPECT_EQ(pushState(history, 6), 0u);
+  EXPECT_EQ(states(history), (std::vector<int>{4, 5, 6}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{1, 2, 0}));
+}
+
+TEST(RetainedHistory, GrowingRenumbersSlotsFromTheOldestState)
+{
+  History history(3);
+
+  for (int state = 0; state < 5; ++state) {
+    pushState(history, state);
+  }
+  EXPECT_EQ(history.setCapacity(5), 0u);
+
+  EXPECT_EQ(states(history), (std::vector<int>{2, 3, 4}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{0, 1, 2}));
+
+  EXPECT_EQ(pushState(history, 5), 3u);
+  EXPECT_EQ(pushState(history, 6), 4u);
+  EXPECT_EQ(pushState(history, 7), 0u);
+  EXPECT_EQ(states(history), (std::vector<int>{3, 4, 5, 6, 7}));
+}
+
+TEST(RetainedHistory, ShrinkingKeepsTheNewestStates)
+{
+  History history(4);
+
+  for (int state = 0; state < 6; ++state) {
+    pushState(history, state);
+  }
+  EXPECT_EQ(history.setCapacity(2), 2u);
+
+  EXPECT_EQ(history.capacity(), 2u);
+  EXPECT_EQ(states(history), (std::vector<int>{4, 5}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{0, 1}));
+
+  EXPECT_EQ(pushState(history, 6), 0u);
+  EXPECT_EQ(states(history), (std::vector<int>{5, 6}));
+  EXPECT_EQ(slots(history), (std::vector<std::size_t>{1, 0}));
+}
+
+TEST(RetainedHistory, ClearRestartsAtTheFirstSlot)
+{
+  History history(2);
+
+  for (int state = 0; state < 3; ++state) {
+    pushState(history, state);
+  }
+  history.clear();
+
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(history.capacity(), 2u);
+  EXPECT_EQ(pushState(history, 3), 0u);
+  EXPECT_EQ(states(history), (std::vector<int>{3}));
+}
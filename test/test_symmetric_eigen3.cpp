@@ -0,0 +1,147 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <array>
+
+#include <geometry_rviz_plugins/math/symmetric_eigen3.hpp>
+
+
+namespace
+{
+using geometry_rviz_plugins::math::Matrix3d;
+using geometry_rviz_plugins::math::Vector3d;
+
+double dot(const Vector3d & a, const Vector3d & b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector3d cross(const Vector3d & a, const Vector3d & b)
+{
+  return {
+    a[1] * b[2] - a[2] * b[1],
+    a[2] * b[0] - a[0] * b[2],
+    a[0] * b[1] - a[1] * b[0]
+  };
+}
+
+Vector3d multiply(const Matrix3d & a, const Vector3d & v)
+{
+  return {
+    a[0] * v[0] + a[1] * v[1] + a[2] * v[2],
+    a[3] * v[0] + a[4] * v[1] + a[5] * v[2],
+    a[6] * v[0] + a[7] * v[1] + a[8] * v[2]
+  };
+}
+
+//! R diag(eigenvalues) R^T for the rotation about the normalized axis
+Matrix3d rotatedDiagonal(const Vector3d & eigenvalues, const Vector3d & axis, double angle)
+{
+  const double norm = std::sqrt(dot(axis, axis));
+  const double x = axis[0] / norm, y = axis[1] / norm, z = axis[2] / norm;
+  const double c = std::cos(angle), s = std::sin(angle), t = 1 - c;
+
+  const Matrix3d rotation{
+    t * x * x + c, t * x * y - s * z, t * x * z + s * y,
+    t * x * y + s * z, t * y * y + c, t * y * z - s * x,
+    t * x * z - s * y, t * y * z + s * x, t * z * z + c
+  };
+  Matrix3d result{};
+
+  for (int row = 0; row < 3; ++row) {
+    for (int column = 0; column < 3; ++column) {
+      for (int k = 0; k < 3; ++k) {
+        result[row * 3 + column] +=
+          rotation[row * 3 + k] * eigenvalues[k] * rotation[column * 3 + k];
+      }
+    }
+  }
+  return result;
+}
+
+void expectDecomposition(const Matrix3d & a, const Vector3d & expected_eigenvalues)
+{
+  const auto eigen = geometry_rviz_plugins::math::solveSymmetricEigen3(a);
+  const double tolerance = 1e-6;
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(eigen.eigenvalues[i], expected_eigenvalues[i], tolerance) << "eigenvalue " << i;
+
+    const Vector3d & v = eigen.eigenvectors[i];
+    const Vector3d av = multiply(a, v);
+
+    for (int component = 0; component < 3; ++component) {
+      EXPECT_NEAR(av[component], eigen.eigenvalues[i] * v[component], tolerance)
+        << "eigenvector " << i << " component " << component;
+    }
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(dot(v, eigen.eigenvectors[j]), i == j ? 1.0 : 0.0, tolerance)
+        << "eigenvectors " << i << " and " << j;
+    }
+  }
+  const Vector3d handedness = cross(eigen.eigenvectors[0], eigen.eigenvectors[1]);
+  EXPECT_NEAR(dot(handedness, eigen.eigenvectors[2]), 1.0, tolerance) << "left handed basis";
+}
+}  // namespace
+
+TEST(SymmetricEigen3, Diagonal)
+{
+  expectDecomposition({1, 0, 0, 0, 3, 0, 0, 0, 2}, {3, 2, 1});
+  expectDecomposition({0.5, 0, 0, 0, 0.25, 0, 0, 0, 0.125}, {0.5, 0.25, 0.125});
+}
+
+TEST(SymmetricEigen3, Zero)
+{
+  expectDecomposition({0, 0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0});
+}
+
+TEST(SymmetricEigen3, Rotated)
+{
+  const Vector3d eigenvalues{4, 2, 1};
+  expectDecomposition(rotatedDiagonal(eigenvalues, {1, 2, 3}, 0.7), eigenvalues);
+}
+
+TEST(SymmetricEigen3, RepeatedEigenvalues)
+{
+  // Isotropic, and both orders of a single repeated pair
+  expectDecomposition({2, 0, 0, 0, 2, 0, 0, 0, 2}, {2, 2, 2});
+  expectDecomposition({2, 0, 0, 0, 2, 0, 0, 0, 1}, {2, 2, 1});
+  expectDecomposition({1, 0, 0, 0, 2, 0, 0, 0, 2}, {2, 2, 1});
+  expectDecomposition(rotatedDiagonal({3, 3, 1}, {1, -1, 0.5}, 1.1), {3, 3, 1});
+  expectDecomposition(rotatedDiagonal({3, 1, 1}, {0.2, 1, -0.4}, 2.3), {3, 1, 1});
+}
+
+TEST(SymmetricEigen3, NearRepeatedEigenvalues)
+{
+  for (const double gap : {1e-4, 1e-7, 1e-10, 1e-13}) {
+    expectDecomposition(
+      rotatedDiagonal({1 + gap, 1, 0.5}, {3, 1, 2}, 0.4),
+      {1 + gap, 1, 0.5}
+    );
+    expectDecomposition(
+      rotatedDiagonal({2, 1 + gap, 1}, {-1, 2, 1}, 1.9),
+      {2, 1 + gap, 1}
+    );
+  }
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2022 Naoki Takahashi
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <geometry_rviz_plugins/filter/temporal_filter.hpp>
+
+
+namespace
+{
+using geometry_rviz_plugins::filter::FilterType;
+using geometry_rviz_plugins::filter::ScalarFilter;
+using geometry_rviz_plugins::filter::TemporalFilterProperties;
+
+double bruteForceMean(const std::deque<double> & window)
+{
+  return std::accumulate(window.begin(), window.end(), 0.0) /
+         static_cast<double>(window.size());
+}
+
+double bruteForceMedian(const std::deque<double> & window)
+{
+  std::vector<double> sorted(window.begin(), window.end());
+  std::sort(sorted.begin(), sorted.end());
+
+  const std::size_t middle = sorted.size() / 2;
+
+  if (sorted.size() % 2 == 1) {
+    return sorted[middle];
+  }
+  return 0.5 * (sorted[middle - 1] + sorted[middle]);
+}
+
+//! Few distinct values, so the windows hold many duplicates
+std::vector<double> makeSamples(std::size_t count, int distinct_values)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> distribution(0, distinct_values - 1);
+  std::vector<double> samples(count);
+
+  for (auto & sample : samples) {
+    sample = 0.25 * distribution(generator);
+  }
+  return samples;
+}
+
+void expectMatchesBruteForce(
+  FilterType type,
+  double (* brute_force)(const std::deque<double> &)
+)
+{
+  for (const std::size_t window_size : {1, 2, 3, 4, 7, 16}) {
+    for (const int distinct_values : {3, 1000}) {
+      ScalarFilter filter;
+      filter.setProperties(TemporalFilterProperties{type, window_size, 1.0});
+
+      std::deque<double> window;
+      const auto samples = makeSamples(500, distinct_values);
+
+      for (std::size_t i = 0; i < samples.size(); ++i) {
+        window.push_back(samples[i]);
+
+        if (window.size() > window_size) {
+          window.pop_front();
+        }
+        ASSERT_NEAR(filter.filter(samples[i]), brute_force(window), 1e-9)
+          << "window " << window_size << ", sample " << i;
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(ScalarFilter, MovingAverageMatchesBruteForce)
+{
+  expectMatchesBruteForce(FilterType::MOVING_AVERAGE, bruteForceMean);
+}
+
+TEST(ScalarFilter, MedianMatchesBruteForce)
+{
+  expectMatchesBruteForce(FilterType::MEDIAN, bruteForceMedian);
+}
+
+TEST(ScalarFilter, ResetRestartsTheWindow)
+{
+  ScalarFilter filter;
+  filter.setProperties(TemporalFilterProperties{FilterType::MEDIAN, 3, 1.0});
+
+  filter.filter(10);
+  filter.filter(20);
+  filter.reset();
+
+  EXPECT_EQ(filter.filter(1), 1);
+  EXPECT_EQ(filter.filter(3), 2);
+}
+
+TEST(ScalarFilter, PassesNonFiniteSamplesThrough)
+{
+  ScalarFilter filter;
+  filter.setProperties(TemporalFilterProperties{FilterType::MOVING_AVERAGE, 2, 1.0});
+
+  EXPECT_EQ(filter.filter(2), 2);
+  EXPECT_TRUE(std::isnan(filter.filter(std::nan(""))));
+  EXPECT_EQ(filter.filter(4), 3);
+}